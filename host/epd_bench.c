@@ -0,0 +1,396 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "esp_log.h"
+#include "lcd/epd_lcd_ssd1680.h"
+#include "lcd/epdpaint.h"
+#include "static/static.h"
+#include "page_manager.h"
+#include "ssd1680_emu.h"
+
+/**
+ * time every epd_paint primitive in all rotations and the draw of every page,
+ * one csv line per case: ns per call and pixel throughput.
+ * cases with a baseline also time the old implementation it replaced, same call, and the speedup.
+ * jpg is not decoded on host and draw_bitmap_file_with_align has no implementation, both are left out.
+ */
+
+#define FRAME_SIZE (LCD_H_RES * LCD_V_RES / 8)
+#define BENCH_TEXT "AniyaBox 12:34"
+// 中 in gb2312, glyph of draw_char for chinese font
+#define BENCH_CHINESE_CHAR 0xD0D6
+// pixels of font case are of one glyph, not of BENCH_TEXT
+#define PIXELS_GLYPH -2
+
+typedef void (*bench_fn)(epd_paint_t *p);
+
+// not in epdpaint.h, draw_string_at calls them for every char
+void epd_paint_draw_char_at(epd_paint_t *epd_paint, int x, int y, char ascii_char, sFONT *font, int colored);
+
+void epd_paint_draw_chinese_char_at(epd_paint_t *epd_paint, int x, int y, uint16_t font_char, sFONT *font, int colored);
+
+typedef struct {
+    const char *name;
+    bench_fn fn;
+    int pixels; // pixels touched per call, 0 = whole frame
+    bench_fn baseline; // old implementation of fn, NULL if none
+} bench_case_t;
+
+// source bmp of the embedded epi, host embeds both to compare the decoders
+extern const uint8_t aniya_200_1_bmp_start[] asm("_binary_aniya_200_1_bmp_start");
+extern const uint8_t aniya_200_1_bmp_end[] asm("_binary_aniya_200_1_bmp_end");
+
+static int64_t min_run_ns = 20 * 1000 * 1000;
+static FILE *bmp_file;
+static FILE *epi_file;
+static sFONT *current_font;
+
+static int64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void bench_clear(epd_paint_t *p) { epd_paint_clear(p, 0); }
+
+static void bench_clear_range(epd_paint_t *p) { epd_paint_clear_range(p, 20, 20, 120, 80, 1); }
+
+static void bench_reverse_range(epd_paint_t *p) { epd_paint_reverse_range(p, 20, 20, 120, 80); }
+
+static void bench_draw_pixel(epd_paint_t *p) {
+    for (int i = 0; i < 100; i++) {
+        epd_paint_draw_pixel(p, i, i, 1);
+    }
+}
+
+/**
+ * epd_paint_draw_pixel before per rotation writers: rotation switch and color branch for every pixel.
+ * noinline like the old extern functions of epdpaint.c, or the switch is hoisted out of the bench loop.
+ * writers of now also grow the dirty area for frame diff, old code had no dirty area
+ */
+static __attribute__((noinline)) void legacy_draw_absolute_pixel(epd_paint_t *p, int x, int y, uint8_t colored) {
+    if (x < 0 || x >= p->width || y < 0 || y >= p->height) {
+        return;
+    }
+    if (IF_INVERT_COLOR) {
+        if (colored) {
+            p->image[(x + y * p->width) / 8] |= 0x80 >> (x % 8);
+        } else {
+            p->image[(x + y * p->width) / 8] &= ~(0x80 >> (x % 8));
+        }
+    } else {
+        if (colored) {
+            p->image[(x + y * p->width) / 8] &= ~(0x80 >> (x % 8));
+        } else {
+            p->image[(x + y * p->width) / 8] |= 0x80 >> (x % 8);
+        }
+    }
+}
+
+static __attribute__((noinline)) void legacy_draw_pixel(epd_paint_t *p, int x, int y, int colored) {
+    int point_temp;
+    if (p->rotate == ROTATE_0) {
+        if (x < 0 || x >= p->width || y < 0 || y >= p->height) {
+            return;
+        }
+        legacy_draw_absolute_pixel(p, x, y, colored);
+    } else if (p->rotate == ROTATE_90) {
+        if (x < 0 || x >= p->height || y < 0 || y >= p->width) {
+            return;
+        }
+        point_temp = x;
+        x = p->width - y;
+        y = point_temp;
+        legacy_draw_absolute_pixel(p, x, y, colored);
+    } else if (p->rotate == ROTATE_180) {
+        if (x < 0 || x >= p->width || y < 0 || y >= p->height) {
+            return;
+        }
+        x = p->width - x;
+        y = p->height - y;
+        legacy_draw_absolute_pixel(p, x, y, colored);
+    } else if (p->rotate == ROTATE_270) {
+        if (x < 0 || x >= p->height || y < 0 || y >= p->width) {
+            return;
+        }
+        point_temp = x;
+        x = y;
+        y = p->height - point_temp;
+        legacy_draw_absolute_pixel(p, x, y, colored);
+    }
+}
+
+static void bench_draw_pixel_legacy(epd_paint_t *p) {
+    for (int i = 0; i < 100; i++) {
+        legacy_draw_pixel(p, i, i, 1);
+    }
+}
+
+static void bench_get_pixel(epd_paint_t *p) {
+    volatile uint8_t sum = 0;
+    for (int i = 0; i < 100; i++) {
+        sum += epd_paint_get_pixel(p, i, i);
+    }
+}
+
+static void bench_line(epd_paint_t *p) { epd_paint_draw_line(p, 0, 0, 150, 99, 1); }
+
+static void bench_hline(epd_paint_t *p) { epd_paint_draw_horizontal_line(p, 10, 50, 150, 1); }
+
+static void bench_vline(epd_paint_t *p) { epd_paint_draw_vertical_line(p, 50, 10, 150, 1); }
+
+static void bench_hline_doted(epd_paint_t *p) { epd_paint_draw_horizontal_doted_line(p, 10, 50, 150, 1); }
+
+static void bench_vline_doted(epd_paint_t *p) { epd_paint_draw_vertical_doted_line(p, 50, 10, 150, 1); }
+
+static void bench_rect(epd_paint_t *p) { epd_paint_draw_rectangle(p, 20, 20, 139, 99, 1); }
+
+static void bench_rect_doted(epd_paint_t *p) { epd_paint_draw_doted_rectangle(p, 20, 20, 139, 99, 1); }
+
+static void bench_rect_filled(epd_paint_t *p) { epd_paint_draw_filled_rectangle(p, 20, 20, 139, 99, 1); }
+
+static void bench_circle(epd_paint_t *p) { epd_paint_draw_circle(p, 100, 100, 40, 1); }
+
+static void bench_circle_filled(epd_paint_t *p) { epd_paint_draw_filled_circle(p, 100, 100, 40, 1); }
+
+static void bench_string(epd_paint_t *p) { epd_paint_draw_string_at(p, 4, 4, BENCH_TEXT, current_font, 1); }
+
+static void bench_string_position(epd_paint_t *p) {
+    epd_paint_draw_string_at_position(p, 0, 0, p->rotated_width, p->rotated_height, BENCH_TEXT, current_font,
+                                      ALIGN_CENTER, ALIGN_CENTER, 1);
+}
+
+static void bench_string_width(epd_paint_t *p) {
+    volatile uint16_t w = epd_paint_calc_string_width(p, BENCH_TEXT, current_font);
+}
+
+static void bench_char(epd_paint_t *p) {
+    if (current_font->is_chinese) {
+        epd_paint_draw_chinese_char_at(p, 4, 4, BENCH_CHINESE_CHAR, current_font, 1);
+    } else {
+        epd_paint_draw_char_at(p, 4, 4, 'A', current_font, 1);
+    }
+}
+
+/**
+ * epd_paint_draw_char_at before the glyph blitter, every set bit of glyph drawn by epd_paint_draw_pixel
+ */
+static __attribute__((noinline)) void legacy_draw_glyph(epd_paint_t *p, int x, int y, const uint8_t *ptr,
+                                                        sFONT *font, int colored) {
+    int i, j;
+    for (j = 0; j < font->Height; j++) {
+        for (i = 0; i < font->Width; i++) {
+            if (*ptr & (0x80 >> (i % 8))) {
+                epd_paint_draw_pixel(p, x + i, y + j, colored);
+            }
+            if (i % 8 == 7) {
+                ptr++;
+            }
+        }
+        if (font->Width % 8 != 0) {
+            ptr++;
+        }
+    }
+}
+
+static void bench_char_legacy(epd_paint_t *p) {
+    unsigned int glyph_size = current_font->Height * (current_font->Width / 8 + (current_font->Width % 8 ? 1 : 0));
+    unsigned int index;
+    if (current_font->is_chinese) {
+        index = 94 * ((BENCH_CHINESE_CHAR & 0xff) - 0xa0 - 1) + ((BENCH_CHINESE_CHAR >> 8) - 0xa0 - 1);
+    } else {
+        index = 'A' - current_font->start;
+    }
+    legacy_draw_glyph(p, 4, 4, &current_font->table[index * glyph_size], current_font, 1);
+}
+
+static void bench_bitmap(epd_paint_t *p) {
+    epd_paint_draw_bitmap(p, 0, 0, 200, 200, (uint8_t *) aniya_200_1_bmp_start,
+                          aniya_200_1_bmp_end - aniya_200_1_bmp_start, 1);
+}
+
+static void bench_bitmap_file(epd_paint_t *p) {
+    rewind(bmp_file);
+    epd_paint_draw_bitmap_file(p, 0, 0, 200, 200, bmp_file, DITHER_FLOYD_STEINBERG, 1);
+}
+
+static void bench_epi(epd_paint_t *p) {
+    epd_paint_draw_epi(p, 0, 0, 200, 200, aniya_200_1_epi_start, aniya_200_1_epi_end - aniya_200_1_epi_start, 1);
+}
+
+static void bench_epi_file(epd_paint_t *p) {
+    rewind(epi_file);
+    epd_paint_draw_epi_file(p, 0, 0, 200, 200, epi_file, 1);
+}
+
+static void bench_icon(epd_paint_t *p) { epd_paint_draw_icon(p, ICON_HOME, 8, 8, 1); }
+
+static const bench_case_t primitive_cases[] = {
+        {"clear",                   bench_clear,             0},
+        {"clear_range",             bench_clear_range,       120 * 80},
+        {"reverse_range",           bench_reverse_range,     120 * 80},
+        {"draw_pixel_x100",         bench_draw_pixel,        100, bench_draw_pixel_legacy},
+        {"get_pixel_x100",          bench_get_pixel,         100},
+        {"draw_line",               bench_line,              151},
+        {"draw_horizontal_line",    bench_hline,             150},
+        {"draw_vertical_line",      bench_vline,             150},
+        {"draw_horizontal_doted",   bench_hline_doted,       150},
+        {"draw_vertical_doted",     bench_vline_doted,       150},
+        {"draw_rectangle",          bench_rect,              2 * (120 + 80)},
+        {"draw_doted_rectangle",    bench_rect_doted,        2 * (120 + 80)},
+        {"draw_filled_rectangle",   bench_rect_filled,       120 * 80},
+        {"draw_circle",             bench_circle,            251},
+        {"draw_filled_circle",      bench_circle_filled,     81 * 81},
+        {"draw_bitmap",             bench_bitmap,            0},
+        {"draw_bitmap_file",        bench_bitmap_file,       0},
+        {"draw_epi",                bench_epi,               0},
+        {"draw_epi_file",           bench_epi_file,          0},
+        {"draw_icon",               bench_icon,              35 * 32},
+};
+
+static const bench_case_t font_cases[] = {
+        {"draw_string_at",          bench_string,            -1},
+        {"draw_string_at_position", bench_string_position,   -1},
+        {"calc_string_width",       bench_string_width,      -1},
+        {"draw_char",               bench_char,              PIXELS_GLYPH, bench_char_legacy},
+};
+
+static sFONT *const fonts[] = {&Font8, &Font12, &Font16, &Font20, &Font24, &Font_HZK16};
+static const char *const font_names[] = {"Font8", "Font12", "Font16", "Font20", "Font24", "Font_HZK16"};
+
+/**
+ * call fn until min_run_ns passed, at least twice so first call warm up is amortized, return ns per call
+ */
+static double time_fn(epd_paint_t *p, bench_fn fn, uint32_t *calls) {
+    *calls = 0;
+    fn(p);
+    int64_t start = now_ns();
+    int64_t elapsed;
+    do {
+        fn(p);
+        (*calls)++;
+        elapsed = now_ns() - start;
+    } while (elapsed < min_run_ns || *calls < 2);
+    return (double) elapsed / *calls;
+}
+
+static void run_case(epd_paint_t *p, const char *group, const char *name, const char *variant, bench_fn fn,
+                     int pixels, bench_fn baseline) {
+    uint32_t calls;
+    double ns_per_call = time_fn(p, fn, &calls);
+
+    if (pixels == 0) {
+        pixels = LCD_H_RES * LCD_V_RES;
+    }
+    printf("%s,%s,%s,%u,%.1f,%d,%.2f,", group, name, variant, calls, ns_per_call, pixels,
+           pixels * 1000.0 / ns_per_call);
+    if (baseline == NULL) {
+        printf(",\n");
+        return;
+    }
+    // same frame content as fn started with
+    epd_paint_clear(p, 0);
+    uint32_t baseline_calls;
+    double baseline_ns = time_fn(p, baseline, &baseline_calls);
+    printf("%.1f,%.2f\n", baseline_ns, baseline_ns / ns_per_call);
+}
+
+static void run_primitives(epd_paint_t *p) {
+    static const char *const rotation_names[] = {"rotate_0", "rotate_90", "rotate_180", "rotate_270"};
+    for (uint8_t rotate = ROTATE_0; rotate <= ROTATE_270; rotate++) {
+        epd_paint_set_rotation(p, rotate);
+        for (size_t i = 0; i < sizeof(primitive_cases) / sizeof(primitive_cases[0]); i++) {
+            epd_paint_clear(p, 0);
+            run_case(p, "primitive", primitive_cases[i].name, rotation_names[rotate], primitive_cases[i].fn,
+                     primitive_cases[i].pixels, primitive_cases[i].baseline);
+        }
+        for (size_t f = 0; f < sizeof(fonts) / sizeof(fonts[0]); f++) {
+            current_font = fonts[f];
+            int pixels = epd_paint_calc_string_width(p, BENCH_TEXT, current_font) * current_font->Height;
+            char variant[32];
+            snprintf(variant, sizeof(variant), "%s/%s", rotation_names[rotate], font_names[f]);
+            for (size_t i = 0; i < sizeof(font_cases) / sizeof(font_cases[0]); i++) {
+                epd_paint_clear(p, 0);
+                int case_pixels = font_cases[i].pixels == PIXELS_GLYPH
+                                  ? current_font->Width * current_font->Height : pixels;
+                run_case(p, "font", font_cases[i].name, variant, font_cases[i].fn, case_pixels,
+                         font_cases[i].baseline);
+            }
+        }
+    }
+    epd_paint_set_rotation(p, ROTATE_0);
+}
+
+static on_draw_page_cb current_page_draw;
+static uint32_t page_loop_cnt;
+
+static void bench_page_draw(epd_paint_t *p) {
+    current_page_draw(p, page_loop_cnt++);
+}
+
+static void run_pages(epd_paint_t *p) {
+    for (int8_t i = 0; i < page_manager_get_page_count(); i++) {
+        page_manager_switch_page_by_index(i, false);
+        page_inst_t page = page_manager_get_current_page();
+        if (page.on_draw_page == NULL) {
+            continue;
+        }
+        current_page_draw = page.on_draw_page;
+        page_loop_cnt = 0;
+        epd_paint_set_rotation(p, ROTATE_0);
+        epd_paint_clear(p, 0);
+        run_case(p, "page", page.page_name, "on_draw_page", bench_page_draw, 0, NULL);
+    }
+}
+
+int main(int argc, char **argv) {
+    int opt;
+    while ((opt = getopt(argc, argv, "t:v")) != -1) {
+        switch (opt) {
+            case 't':
+                min_run_ns = atoll(optarg) * 1000 * 1000;
+                break;
+            case 'v':
+                host_log_level = ESP_LOG_INFO;
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-t min_ms_per_case] [-v]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    // bitmap file cases read the embedded image back from a temp file, like image page from spiffs
+    bmp_file = tmpfile();
+    if (bmp_file == NULL) {
+        perror("tmpfile");
+        return 1;
+    }
+    fwrite(aniya_200_1_bmp_start, 1, aniya_200_1_bmp_end - aniya_200_1_bmp_start, bmp_file);
+    epi_file = tmpfile();
+    if (epi_file == NULL) {
+        perror("tmpfile");
+        return 1;
+    }
+    fwrite(aniya_200_1_epi_start, 1, aniya_200_1_epi_end - aniya_200_1_epi_start, epi_file);
+
+    ssd1680_emu_reset();
+    epd_panel_driver_init(SPI2_HOST);
+    epd_panel_reset();
+
+    epd_paint_t epd_paint;
+    uint8_t *image = malloc(FRAME_SIZE);
+    epd_paint_init(&epd_paint, image, LCD_H_RES, LCD_V_RES, ROTATE_0);
+
+    printf("group,name,variant,calls,ns_per_call,pixels_per_call,mpixels_per_s,baseline_ns_per_call,speedup\n");
+    run_primitives(&epd_paint);
+    run_pages(&epd_paint);
+
+    epd_panel_del();
+    epd_paint_deinit(&epd_paint);
+    fclose(bmp_file);
+    fclose(epi_file);
+    return 0;
+}
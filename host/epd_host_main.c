@@ -0,0 +1,196 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "lcd/epd_lcd_ssd1680.h"
+#include "lcd/epdpaint.h"
+#include "lcd/epd_frame_diff.h"
+#include "static/static.h"
+#include "view/button_view.h"
+#include "view/checkbox_view.h"
+#include "view/switch_view.h"
+#include "view/slider_view.h"
+#include "view/battery_view.h"
+#include "ssd1680_emu.h"
+
+/**
+ * draw sample frames with the real paint / view / driver code,
+ * upload them like display.c does and dump what the emulated panel shows.
+ */
+
+#define FRAME_SIZE (LCD_H_RES * LCD_V_RES / 8)
+#define MAX_BANDS 4
+
+static const char *out_dir = ".";
+static uint8_t shadow_image[FRAME_SIZE];
+static int frame_index = 0;
+static int write_failed = 0;
+
+/**
+ * upload like gui task: whole frame for full refresh, else changed bands of dirty area
+ */
+static void upload_and_refresh(epd_paint_t *epd_paint, bool full) {
+    epd_panel_init(full ? EPD_REFRESH_MODE_FULL : EPD_REFRESH_MODE_PARTIAL);
+    if (full) {
+        epd_panel_draw_bitmap(0, 0, LCD_H_RES, LCD_V_RES, epd_paint->image);
+        memcpy(shadow_image, epd_paint->image, FRAME_SIZE);
+        epd_panel_refresh(true, false);
+        epd_paint_reset_dirty(epd_paint);
+        return;
+    }
+
+    int x, y, end_x, end_y;
+    if (epd_paint_get_dirty_area(epd_paint, &x, &y, &end_x, &end_y)) {
+        epd_area_t bands[MAX_BANDS];
+        uint8_t count = epd_frame_diff(shadow_image, epd_paint->image, LCD_H_RES / 8, y, end_y, bands, MAX_BANDS);
+        epd_area_t area = bands[0];
+        for (uint8_t i = 0; i < count; i++) {
+            epd_panel_draw_frame_area(bands[i].x, bands[i].y, bands[i].end_x, bands[i].end_y, epd_paint->image);
+            epd_frame_copy_area(shadow_image, epd_paint->image, LCD_H_RES / 8, &bands[i]);
+            area.x = bands[i].x < area.x ? bands[i].x : area.x;
+            area.y = bands[i].y < area.y ? bands[i].y : area.y;
+            area.end_x = bands[i].end_x > area.end_x ? bands[i].end_x : area.end_x;
+            area.end_y = bands[i].end_y > area.end_y ? bands[i].end_y : area.end_y;
+        }
+        if (count > 0) {
+            epd_panel_refresh_area(area.x, area.y, area.end_x, area.end_y, false);
+        }
+    }
+    epd_paint_reset_dirty(epd_paint);
+}
+
+static void draw_fonts(epd_paint_t *p) {
+    epd_paint_clear(p, 0);
+    epd_paint_draw_string_at(p, 2, 2, "Font24 Aniya", &Font24, 1);
+    epd_paint_draw_string_at(p, 2, 30, "Font20 Aniya", &Font20, 1);
+    epd_paint_draw_string_at(p, 2, 54, "Font16 Aniya box", &Font16, 1);
+    epd_paint_draw_string_at(p, 2, 74, "Font12 Aniya box 0123", &Font12, 1);
+    epd_paint_draw_string_at(p, 2, 90, "Font8 Aniya box 0123456789", &Font8, 1);
+}
+
+static void draw_shapes(epd_paint_t *p) {
+    epd_paint_clear(p, 0);
+    epd_paint_draw_rectangle(p, 4, 4, 96, 96, 1);
+    epd_paint_draw_filled_rectangle(p, 104, 4, 196, 96, 1);
+    epd_paint_draw_circle(p, 50, 150, 40, 1);
+    epd_paint_draw_filled_circle(p, 150, 150, 40, 1);
+    epd_paint_draw_line(p, 0, 0, 199, 199, 1);
+    epd_paint_draw_horizontal_doted_line(p, 0, 100, 200, 1);
+    epd_paint_reverse_range(p, 120, 120, 60, 20);
+}
+
+static void draw_views(epd_paint_t *p) {
+    epd_paint_clear(p, 0);
+    view_t *button = button_view_create("OK", &Font16);
+    view_t *checkbox = checkbox_view_create(true);
+    view_t *sw = switch_view_create(1);
+    view_t *slider = slider_view_create(60, 0, 100);
+    battery_view_t *battery = battery_view_create(70, 30, 14);
+
+    button_view_draw(button, p, 10, 10);
+    checkbox_view_draw(checkbox, p, 10, 50);
+    switch_view_draw(sw, p, 60, 50);
+    slider_view_draw(slider, p, 10, 90);
+    battery_view_draw(battery, p, 150, 10);
+
+    button_view_delete(button);
+    checkbox_view_delete(checkbox);
+    switch_view_delete(sw);
+    slider_view_delete(slider);
+    battery_view_deinit(battery);
+}
+
+static void draw_rotated(epd_paint_t *p, uint8_t rotate) {
+    epd_paint_set_rotation(p, rotate);
+    epd_paint_clear(p, 0);
+    epd_paint_draw_string_at(p, 4, 4, "rotate", &Font24, 1);
+    epd_paint_draw_rectangle(p, 2, 2, 120, 30, 1);
+    epd_paint_set_rotation(p, ROTATE_0);
+}
+
+static void draw_clock_digit(epd_paint_t *p, int n) {
+    char buf[8];
+    snprintf(buf, sizeof(buf), "12:%02d", n);
+    epd_paint_clear_range(p, 40, 160, 120, 24, 0);
+    epd_paint_draw_string_at(p, 40, 160, buf, &Font24, 1);
+}
+
+static void draw_bitmap(epd_paint_t *p) {
+    epd_paint_clear(p, 0);
+    epd_paint_draw_epi(p, 0, 0, 200, 200, aniya_200_1_epi_start,
+                       aniya_200_1_epi_end - aniya_200_1_epi_start, 1);
+}
+
+static void dump_frame(const char *name, int64_t draw_us) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%03d_%s.pbm", out_dir, frame_index++, name);
+    if (ssd1680_emu_dump_pbm(path) != 0) {
+        fprintf(stderr, "write %s failed\n", path);
+        write_failed++;
+    }
+
+    const ssd1680_emu_stats_t *stats = ssd1680_emu_get_stats();
+    printf("%s,%lld,%u,%u,%u,%llu,%u,%u\n", name, (long long) draw_us, stats->data_bytes, stats->transactions,
+           stats->cmd_count, (unsigned long long) stats->spi_time_us, stats->full_refresh, stats->partial_refresh);
+    ssd1680_emu_reset_stats();
+}
+
+#define RUN_FRAME(name, full, draw) do { \
+        int64_t start = esp_timer_get_time(); \
+        draw; \
+        int64_t draw_us = esp_timer_get_time() - start; \
+        upload_and_refresh(&epd_paint, full); \
+        dump_frame(name, draw_us); \
+    } while (0)
+
+int main(int argc, char **argv) {
+    int opt;
+    while ((opt = getopt(argc, argv, "o:v")) != -1) {
+        switch (opt) {
+            case 'o':
+                out_dir = optarg;
+                break;
+            case 'v':
+                host_log_level = ESP_LOG_INFO;
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-o out_dir] [-v]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    if (mkdir(out_dir, 0755) != 0 && errno != EEXIST) {
+        fprintf(stderr, "create %s failed: %s\n", out_dir, strerror(errno));
+        return 1;
+    }
+
+    ssd1680_emu_reset();
+    epd_panel_driver_init(SPI2_HOST);
+    epd_panel_reset();
+    ssd1680_emu_reset_stats();
+
+    epd_paint_t epd_paint;
+    uint8_t *image = malloc(FRAME_SIZE);
+    epd_paint_init(&epd_paint, image, LCD_H_RES, LCD_V_RES, ROTATE_0);
+
+    printf("frame,draw_us,spi_data_bytes,spi_transactions,commands,est_spi_us,full_refresh,partial_refresh\n");
+    RUN_FRAME("fonts", true, draw_fonts(&epd_paint));
+    RUN_FRAME("shapes", false, draw_shapes(&epd_paint));
+    RUN_FRAME("views", false, draw_views(&epd_paint));
+    RUN_FRAME("rotate_90", false, draw_rotated(&epd_paint, ROTATE_90));
+    RUN_FRAME("rotate_180", false, draw_rotated(&epd_paint, ROTATE_180));
+    RUN_FRAME("rotate_270", false, draw_rotated(&epd_paint, ROTATE_270));
+    RUN_FRAME("clock_00", false, draw_clock_digit(&epd_paint, 0));
+    RUN_FRAME("clock_01", false, draw_clock_digit(&epd_paint, 1));
+    RUN_FRAME("bitmap", true, draw_bitmap(&epd_paint));
+
+    epd_panel_sleep();
+    epd_panel_del();
+    epd_paint_deinit(&epd_paint);
+    return write_failed ? 1 : 0;
+}
@@ -0,0 +1,269 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_event.h"
+#include "esp_system.h"
+#include "driver/gpio.h"
+#include "driver/spi_master.h"
+
+#include "lcd/epd_lcd_ssd1680.h"
+#include "ssd1680_emu.h"
+
+/**
+ * esp-idf functions used by the lcd code, backed by the ssd1680 emulator.
+ * everything runs in one thread, queued spi transactions are sent at once.
+ */
+
+#define HOST_GPIO_COUNT 64
+#define HOST_SPI_QUEUE_SIZE 32
+
+esp_log_level_t host_log_level = ESP_LOG_WARN;
+
+static uint8_t gpio_levels[HOST_GPIO_COUNT];
+
+struct spi_device_t {
+    spi_device_interface_config_t config;
+    spi_transaction_t *done[HOST_SPI_QUEUE_SIZE];
+    int done_head;
+    int done_count;
+};
+
+static struct spi_device_t spi_device;
+
+int64_t esp_timer_get_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void vTaskDelay(TickType_t ticks) {
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return (TickType_t) (esp_timer_get_time() / 1000 / portTICK_PERIOD_MS);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    return &spi_device;
+}
+
+uint32_t ulTaskGenericNotifyTake(UBaseType_t index, BaseType_t clear_on_exit, TickType_t ticks_to_wait) {
+    // emulated panel is never busy
+    return 1;
+}
+
+void vTaskGenericNotifyGiveFromISR(TaskHandle_t task, UBaseType_t index, BaseType_t *higher_priority_task_woken) {
+}
+
+BaseType_t xTaskCreate(TaskFunction_t task_code, const char *name, uint32_t stack_depth, void *parameters,
+                       UBaseType_t priority, TaskHandle_t *created_task) {
+    if (created_task) {
+        *created_task = NULL;
+    }
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task) {
+}
+
+size_t heap_caps_get_free_size(uint32_t caps) {
+    // about what esp32h2 has free after boot
+    return 160 * 1024;
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task) {
+    return 1;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+    return &spi_device;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait) {
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks_to_wait) {
+    return pdFALSE;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+    return &spi_device;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+    return &spi_device;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks_to_wait) {
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+    return pdTRUE;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args, esp_timer_handle_t *out_handle) {
+    *out_handle = (esp_timer_handle_t) &spi_device;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us) {
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_restart(esp_timer_handle_t timer, uint64_t timeout_us) {
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+    return ESP_OK;
+}
+
+bool esp_timer_is_active(esp_timer_handle_t timer) {
+    return false;
+}
+
+esp_err_t esp_event_handler_register(esp_event_base_t event_base, int32_t event_id, esp_event_handler_t event_handler,
+                                     void *event_handler_arg) {
+    return ESP_OK;
+}
+
+esp_err_t esp_event_handler_unregister(esp_event_base_t event_base, int32_t event_id,
+                                       esp_event_handler_t event_handler) {
+    return ESP_OK;
+}
+
+uint32_t esp_get_free_heap_size(void) {
+    return 256 * 1024;
+}
+
+void esp_restart(void) {
+    fprintf(stderr, "esp_restart called\n");
+    exit(1);
+}
+
+// newlib has strlcpy, glibc before 2.38 does not
+size_t strlcpy(char *dst, const char *src, size_t size) {
+    size_t len = strlen(src);
+    if (size > 0) {
+        size_t n = len < size - 1 ? len : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return len;
+}
+
+esp_err_t gpio_config(const gpio_config_t *config) {
+    return ESP_OK;
+}
+
+esp_err_t gpio_reset_pin(gpio_num_t gpio_num) {
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level) {
+    if (gpio_num < 0 || gpio_num >= HOST_GPIO_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // rising edge of reset line is a hardware reset
+    if (gpio_num == DISP_RST_GPIO_NUM && level && !gpio_levels[gpio_num]) {
+        ssd1680_emu_reset();
+    }
+    gpio_levels[gpio_num] = level;
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t gpio_num) {
+    if (gpio_num == DISP_BUSY_GPIO_NUM) {
+        return 0;
+    }
+    return gpio_num >= 0 && gpio_num < HOST_GPIO_COUNT ? gpio_levels[gpio_num] : 0;
+}
+
+esp_err_t gpio_install_isr_service(int intr_alloc_flags) {
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio_num, gpio_isr_t isr_handler, void *args) {
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_remove(gpio_num_t gpio_num) {
+    return ESP_OK;
+}
+
+esp_err_t gpio_intr_enable(gpio_num_t gpio_num) {
+    return ESP_OK;
+}
+
+esp_err_t gpio_intr_disable(gpio_num_t gpio_num) {
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_initialize(spi_host_device_t host, const spi_bus_config_t *bus_config, spi_dma_chan_t dma_chan) {
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_add_device(spi_host_device_t host, const spi_device_interface_config_t *dev_config,
+                             spi_device_handle_t *handle) {
+    memset(&spi_device, 0, sizeof(spi_device));
+    spi_device.config = *dev_config;
+    *handle = &spi_device;
+    return ESP_OK;
+}
+
+static void transmit(spi_device_handle_t handle, spi_transaction_t *trans) {
+    // pre_cb drives dc gpio from trans->user
+    if (handle->config.pre_cb) {
+        handle->config.pre_cb(trans);
+    }
+    ssd1680_emu_write(gpio_levels[DISP_DC_GPIO_NUM], trans->tx_buffer, trans->length / 8);
+    if (handle->config.post_cb) {
+        handle->config.post_cb(trans);
+    }
+}
+
+esp_err_t spi_device_polling_transmit(spi_device_handle_t handle, spi_transaction_t *trans) {
+    if (handle->done_count > 0) {
+        // same as idf, polling transmit is not allowed with queued transactions in flight
+        return ESP_ERR_INVALID_STATE;
+    }
+    transmit(handle, trans);
+    return ESP_OK;
+}
+
+esp_err_t spi_device_queue_trans(spi_device_handle_t handle, spi_transaction_t *trans, TickType_t ticks_to_wait) {
+    int queue_size = handle->config.queue_size < HOST_SPI_QUEUE_SIZE ? handle->config.queue_size : HOST_SPI_QUEUE_SIZE;
+    if (handle->done_count >= queue_size) {
+        return ESP_ERR_TIMEOUT;
+    }
+    transmit(handle, trans);
+    handle->done[(handle->done_head + handle->done_count) % HOST_SPI_QUEUE_SIZE] = trans;
+    handle->done_count++;
+    return ESP_OK;
+}
+
+esp_err_t spi_device_get_trans_result(spi_device_handle_t handle, spi_transaction_t **trans,
+                                      TickType_t ticks_to_wait) {
+    if (handle->done_count == 0) {
+        return ESP_ERR_TIMEOUT;
+    }
+    *trans = handle->done[handle->done_head];
+    handle->done_head = (handle->done_head + 1) % HOST_SPI_QUEUE_SIZE;
+    handle->done_count--;
+    return ESP_OK;
+}
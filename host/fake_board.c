@@ -0,0 +1,227 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "esp_log.h"
+#include "esp_event.h"
+#include "esp_ota_ops.h"
+#include "esp_sleep.h"
+#include "esp_bt.h"
+#include "esp_spiffs.h"
+#include "common_utils.h"
+#include "file/my_file_common.h"
+#include "lcd/display.h"
+#include "key.h"
+#include "battery.h"
+#include "sht40.h"
+#include "spl06.h"
+#include "max31328.h"
+#include "LIS3DH.h"
+#include "beep/beep.h"
+#include "ble/ble_device.h"
+#include "bles/ble_server.h"
+
+/**
+ * sensors, rtc, ble and storage of the board for pages on host,
+ * fixed readings so every page draw does the same work each run.
+ */
+
+#define FAKE_TEMPERATURE 23.5f
+#define FAKE_HUMIDITY 45.0f
+#define FAKE_BATTERY_VOLTAGE 3900
+#define FAKE_BATTERY_LEVEL 80
+// 2024-05-20 12:34:56 monday
+#define FAKE_TIME_TS 1716208496
+
+ESP_EVENT_DEFINE_BASE(BIKE_REQUEST_UPDATE_DISPLAY_EVENT);
+ESP_EVENT_DEFINE_BASE(BIKE_KEY_EVENT);
+ESP_EVENT_DEFINE_BASE(BIKE_TEMP_HUM_SENSOR_EVENT);
+ESP_EVENT_DEFINE_BASE(BIKE_DATE_TIME_SENSOR_EVENT);
+ESP_EVENT_DEFINE_BASE(PRESSURE_SENSOR_EVENT);
+ESP_EVENT_DEFINE_BASE(BLE_DEVICE_EVENT);
+
+uint32_t boot_count = 1;
+
+// alarm page only builds its views in week mode
+static max31328_alarm_t fake_alarm = {
+        .en = 1,
+        .minute = 30,
+        .hour = 7,
+        .week_mode = ALARM_WEEK_MODE,
+        .day_week_mask = 1,
+};
+
+// update requests of pages go nowhere, nothing runs the gui task
+esp_err_t common_post_event(esp_event_base_t event_base, int32_t event_id) {
+    return ESP_OK;
+}
+
+esp_err_t common_post_event_data(esp_event_base_t event_base, int32_t event_id, const void *event_data,
+                                 size_t event_data_size) {
+    return ESP_OK;
+}
+
+int battery_get_voltage() {
+    return FAKE_BATTERY_VOLTAGE;
+}
+
+int8_t battery_get_level() {
+    return FAKE_BATTERY_LEVEL;
+}
+
+bool battery_is_curving() {
+    return false;
+}
+
+bool battery_start_curving() {
+    return false;
+}
+
+bool battery_is_charge() {
+    return false;
+}
+
+uint32_t battery_get_curving_data_count() {
+    return 0;
+}
+
+void sht40_init() {
+}
+
+esp_err_t sht40_get_temp_hum(float *temp, float *hum) {
+    *temp = FAKE_TEMPERATURE;
+    *hum = FAKE_HUMIDITY;
+    return ESP_OK;
+}
+
+esp_err_t spl06_init() {
+    return ESP_OK;
+}
+
+esp_err_t spl06_start(bool en_fifo, uint16_t interval_ms) {
+    return ESP_OK;
+}
+
+void spl06_deinit() {
+}
+
+esp_err_t max31328_get_time(uint8_t *year, uint8_t *month, uint8_t *day, uint8_t *week, uint8_t *hour, uint8_t *minute,
+                           uint8_t *second) {
+    *year = 24;
+    *month = 5;
+    *day = 20;
+    *week = 1;
+    *hour = 12;
+    *minute = 34;
+    *second = 56;
+    return ESP_OK;
+}
+
+esp_err_t max31328_get_time_ts(time_t *ts) {
+    *ts = FAKE_TIME_TS;
+    return ESP_OK;
+}
+
+esp_err_t max31328_load_alarm1(max31328_alarm_t *alarm) {
+    *alarm = fake_alarm;
+    return ESP_OK;
+}
+
+esp_err_t max31328_set_alarm1(const max31328_alarm_t *alarm) {
+    fake_alarm = *alarm;
+    return ESP_OK;
+}
+
+lis3dh_direction_t lis3dh_get_direction() {
+    return LIS3DH_DIR_TOP;
+}
+
+esp_err_t beep_init(beep_mode_t mode) {
+    return ESP_OK;
+}
+
+esp_err_t beep_start_play(const buzzer_musical_score_t *song, uint16_t song_len) {
+    return ESP_OK;
+}
+
+esp_err_t beep_deinit() {
+    return ESP_OK;
+}
+
+esp_err_t ble_device_init(const ble_device_config_t *config) {
+    return ESP_OK;
+}
+
+esp_err_t ble_device_start_scan(uint8_t duration) {
+    return ESP_OK;
+}
+
+scan_result_t *ble_device_get_scan_rst(uint8_t *result_count) {
+    *result_count = 0;
+    return NULL;
+}
+
+esp_err_t ble_device_connect(ble_addr_t addr) {
+    return ESP_FAIL;
+}
+
+esp_err_t ble_device_deinit() {
+    return ESP_OK;
+}
+
+esp_err_t ble_server_init() {
+    return ESP_OK;
+}
+
+esp_err_t ble_server_stop_adv() {
+    return ESP_OK;
+}
+
+esp_err_t ble_server_deinit() {
+    return ESP_OK;
+}
+
+int ble_gap_conn_active(void) {
+    return 0;
+}
+
+esp_bt_controller_status_t esp_bt_controller_get_status(void) {
+    return ESP_BT_CONTROLLER_STATUS_IDLE;
+}
+
+// no spiffs on host, image page finds no file
+esp_err_t mount_storage(const char *base_path, bool format_when_failed) {
+    return ESP_FAIL;
+}
+
+esp_err_t unmount_storage() {
+    return ESP_OK;
+}
+
+// storage partition of partitions.csv
+esp_err_t esp_spiffs_info(const char *partition_label, size_t *total_bytes, size_t *used_bytes) {
+    *total_bytes = 300 * 1024;
+    *used_bytes = 0;
+    return ESP_OK;
+}
+
+const esp_partition_t *esp_ota_get_running_partition(void) {
+    static const esp_partition_t partition = {
+            .subtype = ESP_PARTITION_SUBTYPE_APP_OTA_MIN,
+            .label = "ota_0",
+    };
+    return &partition;
+}
+
+esp_err_t esp_ota_get_partition_description(const esp_partition_t *partition, esp_app_desc_t *app_desc) {
+    memset(app_desc, 0, sizeof(esp_app_desc_t));
+    strcpy(app_desc->version, "host");
+    strcpy(app_desc->project_name, "epd_host");
+    strcpy(app_desc->date, __DATE__);
+    strcpy(app_desc->time, __TIME__);
+    return ESP_OK;
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause(void) {
+    return ESP_SLEEP_WAKEUP_UNDEFINED;
+}
@@ -0,0 +1,16 @@
+#include "lcd/jpg.h"
+
+// esp_jpeg decoder is not available on host, jpg drawing is skipped
+
+enum jpg_err jpg_header_read(jpg_t *header, uint8_t *data, uint16_t data_len) {
+    return JPG_NOT_SUPPORTED_FORMAT;
+}
+
+enum jpg_err jpg_header_read_file(jpg_t *header, FILE *img_file) {
+    return JPG_NOT_SUPPORTED_FORMAT;
+}
+
+enum jpg_err jpg_file_decode_gray(FILE *img_file, uint16_t max_width, uint16_t max_height,
+                                  jpg_gray_row_cb row_cb, void *ctx) {
+    return JPG_NOT_SUPPORTED_FORMAT;
+}
@@ -0,0 +1,271 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "ssd1680_emu.h"
+
+/**
+ * interpret the ssd1680 command stream sent by epd_lcd_ssd1680.c.
+ * only what the driver uses: ram window, address counters, ram write / auto write and refresh.
+ * refresh copies ram to screen at once, waveform and busy time are not emulated.
+ */
+
+#define CMD_SOFT_RESET              0x12
+#define CMD_DATA_ENTRY_MODE         0x11
+#define CMD_MASTER_ACTIVATION       0x20
+#define CMD_UPDATE_CONTROL_2        0x22
+#define CMD_WRITE_RAM               0x24
+#define CMD_WRITE_RAM_RED           0x26
+#define CMD_WRITE_LUT               0x32
+#define CMD_DISPLAY_OPTION          0x37
+#define CMD_RAM_X_START_END         0x44
+#define CMD_RAM_Y_START_END         0x45
+#define CMD_AUTO_WRITE_RED          0x46
+#define CMD_AUTO_WRITE_BW           0x47
+#define CMD_RAM_X_COUNTER           0x4E
+#define CMD_RAM_Y_COUNTER           0x4F
+
+// display mode 2 (partial) is selected by bit 3 of update control 2
+#define UPDATE_MODE_2_BIT 0x08
+
+#define MAX_PARAM 16
+
+static struct {
+    uint8_t bw_ram[SSD1680_EMU_HEIGHT][SSD1680_EMU_STRIDE];
+    uint8_t red_ram[SSD1680_EMU_HEIGHT][SSD1680_EMU_STRIDE];
+    uint8_t screen[SSD1680_EMU_HEIGHT][SSD1680_EMU_STRIDE];
+
+    uint8_t entry_mode;
+    int x_start, x_end, y_start, y_end;
+    int x_counter, y_counter;
+    uint8_t update_control;
+    bool ping_pong;
+
+    uint8_t cmd;
+    uint8_t param[MAX_PARAM];
+    size_t param_len;
+} emu;
+
+static ssd1680_emu_stats_t stats;
+static ssd1680_emu_trans_t trans_log[SSD1680_EMU_TRANS_LOG_SIZE];
+static size_t trans_log_count;
+
+static void reset_registers() {
+    emu.entry_mode = 0x03;
+    emu.x_start = 0;
+    emu.x_end = SSD1680_EMU_STRIDE - 1;
+    emu.y_start = 0;
+    emu.y_end = SSD1680_EMU_HEIGHT - 1;
+    emu.x_counter = 0;
+    emu.y_counter = 0;
+    emu.update_control = 0xFF;
+    emu.ping_pong = false;
+}
+
+void ssd1680_emu_reset() {
+    memset(emu.bw_ram, 0xFF, sizeof(emu.bw_ram));
+    memset(emu.red_ram, 0xFF, sizeof(emu.red_ram));
+    memset(emu.screen, 0xFF, sizeof(emu.screen));
+    reset_registers();
+    emu.cmd = 0;
+    emu.param_len = 0;
+}
+
+/**
+ * move address counter like data entry mode, x first, wrap inside ram window
+ */
+static void advance_counter() {
+    bool x_inc = emu.entry_mode & 0x01;
+    bool y_inc = emu.entry_mode & 0x02;
+
+    emu.x_counter += x_inc ? 1 : -1;
+    if ((x_inc && emu.x_counter > emu.x_end) || (!x_inc && emu.x_counter < emu.x_end)) {
+        emu.x_counter = emu.x_start;
+        emu.y_counter += y_inc ? 1 : -1;
+        if ((y_inc && emu.y_counter > emu.y_end) || (!y_inc && emu.y_counter < emu.y_end)) {
+            emu.y_counter = emu.y_start;
+        }
+    }
+}
+
+static void write_ram_byte(uint8_t (*ram)[SSD1680_EMU_STRIDE], uint8_t value) {
+    if (emu.x_counter >= 0 && emu.x_counter < SSD1680_EMU_STRIDE
+        && emu.y_counter >= 0 && emu.y_counter < SSD1680_EMU_HEIGHT) {
+        ram[emu.y_counter][emu.x_counter] = value;
+    }
+    advance_counter();
+}
+
+static void refresh() {
+    if (emu.update_control & UPDATE_MODE_2_BIT) {
+        // partial refresh of ram window, driver sets window to refresh area
+        int x0 = emu.x_start < emu.x_end ? emu.x_start : emu.x_end;
+        int x1 = emu.x_start < emu.x_end ? emu.x_end : emu.x_start;
+        int y0 = emu.y_start < emu.y_end ? emu.y_start : emu.y_end;
+        int y1 = emu.y_start < emu.y_end ? emu.y_end : emu.y_start;
+        for (int y = y0; y <= y1 && y < SSD1680_EMU_HEIGHT; y++) {
+            memcpy(&emu.screen[y][x0], &emu.bw_ram[y][x0], x1 - x0 + 1);
+        }
+        stats.partial_refresh++;
+    } else {
+        memcpy(emu.screen, emu.bw_ram, sizeof(emu.screen));
+        stats.full_refresh++;
+    }
+
+    // red ram holds old frame for next partial refresh
+    if (emu.ping_pong || (emu.update_control & UPDATE_MODE_2_BIT)) {
+        memcpy(emu.red_ram, emu.bw_ram, sizeof(emu.red_ram));
+    }
+}
+
+/**
+ * command with all its parameters received
+ */
+static void apply_param(uint8_t value) {
+    if (emu.param_len < MAX_PARAM) {
+        emu.param[emu.param_len] = value;
+    }
+    emu.param_len++;
+    const uint8_t *p = emu.param;
+
+    switch (emu.cmd) {
+        case CMD_DATA_ENTRY_MODE:
+            emu.entry_mode = p[0];
+            break;
+        case CMD_UPDATE_CONTROL_2:
+            emu.update_control = p[0];
+            break;
+        case CMD_DISPLAY_OPTION:
+            if (emu.param_len == 6) {
+                emu.ping_pong = p[5] & 0x40;
+            }
+            break;
+        case CMD_RAM_X_START_END:
+            if (emu.param_len == 2) {
+                emu.x_start = p[0] & 0x3F;
+                emu.x_end = p[1] & 0x3F;
+            }
+            break;
+        case CMD_RAM_Y_START_END:
+            if (emu.param_len == 4) {
+                emu.y_start = p[0] | ((p[1] & 0x01) << 8);
+                emu.y_end = p[2] | ((p[3] & 0x01) << 8);
+            }
+            break;
+        case CMD_RAM_X_COUNTER:
+            emu.x_counter = p[0] & 0x3F;
+            break;
+        case CMD_RAM_Y_COUNTER:
+            if (emu.param_len == 2) {
+                emu.y_counter = p[0] | ((p[1] & 0x01) << 8);
+            }
+            break;
+        case CMD_AUTO_WRITE_BW:
+            memset(emu.bw_ram, (p[0] & 0x80) ? 0xFF : 0x00, sizeof(emu.bw_ram));
+            break;
+        case CMD_AUTO_WRITE_RED:
+            memset(emu.red_ram, (p[0] & 0x80) ? 0xFF : 0x00, sizeof(emu.red_ram));
+            break;
+        default:
+            break;
+    }
+}
+
+static void start_cmd(uint8_t cmd) {
+    emu.cmd = cmd;
+    emu.param_len = 0;
+    stats.cmd_count++;
+    stats.cmd_hist[cmd]++;
+
+    switch (cmd) {
+        case CMD_SOFT_RESET:
+            reset_registers();
+            stats.sw_resets++;
+            break;
+        case CMD_WRITE_LUT:
+            stats.lut_writes++;
+            break;
+        case CMD_MASTER_ACTIVATION:
+            refresh();
+            break;
+        default:
+            break;
+    }
+}
+
+void ssd1680_emu_write(int dc, const uint8_t *data, size_t len) {
+    if (trans_log_count < SSD1680_EMU_TRANS_LOG_SIZE) {
+        ssd1680_emu_trans_t *t = &trans_log[trans_log_count++];
+        t->dc = dc;
+        t->len = len;
+        memset(t->data, 0, sizeof(t->data));
+        memcpy(t->data, data, len < sizeof(t->data) ? len : sizeof(t->data));
+    }
+    stats.transactions++;
+    stats.spi_time_us += SSD1680_EMU_TRANS_OVERHEAD_US + (uint64_t) len * 8 * 1000000 / SSD1680_EMU_SPI_HZ;
+
+    if (!dc) {
+        for (size_t i = 0; i < len; i++) {
+            start_cmd(data[i]);
+        }
+        return;
+    }
+
+    stats.data_bytes += len;
+    for (size_t i = 0; i < len; i++) {
+        switch (emu.cmd) {
+            case CMD_WRITE_RAM:
+                write_ram_byte(emu.bw_ram, data[i]);
+                break;
+            case CMD_WRITE_RAM_RED:
+                write_ram_byte(emu.red_ram, data[i]);
+                break;
+            default:
+                apply_param(data[i]);
+                break;
+        }
+    }
+}
+
+const ssd1680_emu_stats_t *ssd1680_emu_get_stats() {
+    return &stats;
+}
+
+void ssd1680_emu_reset_stats() {
+    memset(&stats, 0, sizeof(stats));
+    trans_log_count = 0;
+}
+
+const ssd1680_emu_trans_t *ssd1680_emu_get_trans_log(size_t *count) {
+    *count = trans_log_count;
+    return trans_log;
+}
+
+const uint8_t *ssd1680_emu_get_screen() {
+    return &emu.screen[0][0];
+}
+
+const uint8_t *ssd1680_emu_get_ram() {
+    return &emu.bw_ram[0][0];
+}
+
+const uint8_t *ssd1680_emu_get_red_ram() {
+    return &emu.red_ram[0][0];
+}
+
+int ssd1680_emu_dump_pbm(const char *path) {
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) {
+        return -1;
+    }
+
+    fprintf(f, "P4\n%d %d\n", SSD1680_EMU_WIDTH, SSD1680_EMU_HEIGHT);
+    // pbm bit 1 is black, panel bit 1 is white
+    for (int y = 0; y < SSD1680_EMU_HEIGHT; y++) {
+        uint8_t row[SSD1680_EMU_STRIDE];
+        for (int x = 0; x < SSD1680_EMU_STRIDE; x++) {
+            row[x] = ~emu.screen[y][x];
+        }
+        fwrite(row, 1, sizeof(row), f);
+    }
+    return fclose(f) == 0 ? 0 : -1;
+}
@@ -0,0 +1,80 @@
+#ifndef SSD1680_EMU_H
+#define SSD1680_EMU_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define SSD1680_EMU_WIDTH 200
+#define SSD1680_EMU_HEIGHT 200
+#define SSD1680_EMU_STRIDE (SSD1680_EMU_WIDTH / 8)
+
+// spi clock of the real panel, used to estimate bus time
+#define SSD1680_EMU_SPI_HZ 10000000
+// cs, dc and driver setup cost of one transaction on target, rough estimate
+#define SSD1680_EMU_TRANS_OVERHEAD_US 8
+
+typedef struct {
+    uint32_t cmd_count;
+    uint32_t cmd_hist[256];
+    uint32_t data_bytes;
+    uint32_t transactions;
+    uint32_t full_refresh;
+    uint32_t partial_refresh;
+    uint32_t lut_writes;
+    uint32_t sw_resets;
+    // estimated time the spi bus is busy on target
+    uint64_t spi_time_us;
+} ssd1680_emu_stats_t;
+
+// transactions kept in log since last ssd1680_emu_reset_stats, later ones only counted
+#define SSD1680_EMU_TRANS_LOG_SIZE 64
+// leading bytes of each transaction kept in log
+#define SSD1680_EMU_TRANS_LOG_DATA 4
+
+typedef struct {
+    int dc;
+    size_t len;
+    uint8_t data[SSD1680_EMU_TRANS_LOG_DATA];
+} ssd1680_emu_trans_t;
+
+/**
+ * panel after hardware reset, ram and screen white
+ */
+void ssd1680_emu_reset();
+
+/**
+ * feed one spi transaction, dc 0 command, 1 data
+ */
+void ssd1680_emu_write(int dc, const uint8_t *data, size_t len);
+
+const ssd1680_emu_stats_t *ssd1680_emu_get_stats();
+
+void ssd1680_emu_reset_stats();
+
+/**
+ * transactions in order they were sent, count is number in log
+ */
+const ssd1680_emu_trans_t *ssd1680_emu_get_trans_log(size_t *count);
+
+/**
+ * image shown on screen after last refresh, 1bpp MSB first, bit 1 white
+ */
+const uint8_t *ssd1680_emu_get_screen();
+
+/**
+ * b/w ram, same layout as screen
+ */
+const uint8_t *ssd1680_emu_get_ram();
+
+/**
+ * red ram, old frame of ping-pong partial refresh
+ */
+const uint8_t *ssd1680_emu_get_red_ram();
+
+/**
+ * write screen to binary pbm (P4), return 0 on success
+ */
+int ssd1680_emu_dump_pbm(const char *path);
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef HOST_DRIVER_I2C_H
+#define HOST_DRIVER_I2C_H
+
+// nothing used on host
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef HOST_ESP_BT_H
+#define HOST_ESP_BT_H
+
+typedef enum {
+    ESP_BT_CONTROLLER_STATUS_IDLE,
+    ESP_BT_CONTROLLER_STATUS_INITED,
+    ESP_BT_CONTROLLER_STATUS_ENABLED,
+} esp_bt_controller_status_t;
+
+esp_bt_controller_status_t esp_bt_controller_get_status(void);
+
+#endif
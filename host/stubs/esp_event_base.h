@@ -0,0 +1,10 @@
+#ifndef HOST_ESP_EVENT_BASE_H
+#define HOST_ESP_EVENT_BASE_H
+
+typedef const char *esp_event_base_t;
+
+#define ESP_EVENT_DECLARE_BASE(id) extern esp_event_base_t const id
+#define ESP_EVENT_DEFINE_BASE(id) esp_event_base_t const id = #id
+#define ESP_EVENT_ANY_ID (-1)
+
+#endif
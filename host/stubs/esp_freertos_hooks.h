@@ -0,0 +1,6 @@
+#ifndef HOST_ESP_FREERTOS_HOOKS_H
+#define HOST_ESP_FREERTOS_HOOKS_H
+
+// nothing used on host
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef HOST_ESP_HTTP_SERVER_H
+#define HOST_ESP_HTTP_SERVER_H
+
+typedef void *httpd_handle_t;
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef HOST_ESP_LCD_PANEL_IO_H
+#define HOST_ESP_LCD_PANEL_IO_H
+
+// nothing used on host
+
+#endif
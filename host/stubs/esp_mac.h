@@ -0,0 +1,6 @@
+#ifndef HOST_ESP_MAC_H
+#define HOST_ESP_MAC_H
+
+// nothing used on host
+
+#endif
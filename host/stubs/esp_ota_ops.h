@@ -0,0 +1,26 @@
+#ifndef HOST_ESP_OTA_OPS_H
+#define HOST_ESP_OTA_OPS_H
+
+#include "esp_err.h"
+
+#define ESP_PARTITION_SUBTYPE_APP_OTA_MIN 0x10
+
+typedef struct {
+    char version[32];
+    char project_name[32];
+    char time[16];
+    char date[16];
+    char idf_ver[32];
+} esp_app_desc_t;
+
+typedef struct {
+    int type;
+    int subtype;
+    char label[17];
+} esp_partition_t;
+
+const esp_partition_t *esp_ota_get_running_partition(void);
+
+esp_err_t esp_ota_get_partition_description(const esp_partition_t *partition, esp_app_desc_t *app_desc);
+
+#endif
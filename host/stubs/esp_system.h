@@ -0,0 +1,10 @@
+#ifndef HOST_ESP_SYSTEM_H
+#define HOST_ESP_SYSTEM_H
+
+#include <stdint.h>
+
+uint32_t esp_get_free_heap_size(void);
+
+void esp_restart(void);
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef HOST_ESP_TYPES_H
+#define HOST_ESP_TYPES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef HOST_ESP_VFS_H
+#define HOST_ESP_VFS_H
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <stddef.h>
+
+// newlib string.h has strlcpy, glibc before 2.38 does not, defined in esp_stubs.c
+size_t strlcpy(char *dst, const char *src, size_t size);
+
+#endif
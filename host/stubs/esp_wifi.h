@@ -0,0 +1,6 @@
+#ifndef HOST_ESP_WIFI_H
+#define HOST_ESP_WIFI_H
+
+// nothing used on host
+
+#endif
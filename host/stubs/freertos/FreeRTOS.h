@@ -0,0 +1,37 @@
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "esp_attr.h"
+
+// single task host build, scheduler calls return at once
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef void *TaskHandle_t;
+typedef void *SemaphoreHandle_t;
+
+#define configTICK_RATE_HZ 100
+#define portMAX_DELAY ((TickType_t) 0xffffffffUL)
+#define portTICK_PERIOD_MS (1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms) ((TickType_t) ((ms) * configTICK_RATE_HZ / 1000))
+#define pdTICKS_TO_MS(ticks) ((uint32_t) ((ticks) * 1000 / configTICK_RATE_HZ))
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdPASS pdTRUE
+#define tskIDLE_PRIORITY 0
+
+#define portYIELD_FROM_ISR(...)
+
+// one thread, critical sections need no lock
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux) ((void) (mux))
+#define portEXIT_CRITICAL(mux) ((void) (mux))
+#define portENTER_CRITICAL_ISR(mux) ((void) (mux))
+#define portEXIT_CRITICAL_ISR(mux) ((void) (mux))
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef HOST_FREERTOS_SEMPHR_H
+#define HOST_FREERTOS_SEMPHR_H
+
+#include "FreeRTOS.h"
+#include "queue.h"
+
+// single task on host, lock never waits
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks_to_wait);
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+
+#endif
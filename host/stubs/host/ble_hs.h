@@ -0,0 +1,45 @@
+#ifndef HOST_BLE_HS_H
+#define HOST_BLE_HS_H
+
+#include <stdint.h>
+#include <sys/queue.h>
+
+// only nimble types named by headers of pages, no ble on host
+struct os_mbuf;
+struct ble_gap_conn_desc;
+struct ble_hs_adv_fields;
+
+typedef struct ble_uuid {
+    uint8_t type;
+} ble_uuid_t;
+
+typedef struct {
+    ble_uuid_t u;
+    uint8_t value[16];
+} ble_uuid128_t;
+
+#define BLE_UUID128_INIT(...) { .u = { .type = 128 }, .value = { __VA_ARGS__ } }
+
+typedef struct {
+    uint8_t type;
+    uint8_t val[6];
+} ble_addr_t;
+
+struct ble_gatt_svc {
+    uint16_t start_handle;
+    uint16_t end_handle;
+};
+
+struct ble_gatt_chr {
+    uint16_t def_handle;
+    uint16_t val_handle;
+    uint8_t properties;
+};
+
+struct ble_gatt_dsc {
+    uint16_t handle;
+};
+
+int ble_gap_conn_active(void);
+
+#endif
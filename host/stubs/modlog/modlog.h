@@ -0,0 +1,6 @@
+#ifndef HOST_MODLOG_H
+#define HOST_MODLOG_H
+
+#define MODLOG_DFLT(level, ...)
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef HOST_SOC_GPIO_NUM_H
+#define HOST_SOC_GPIO_NUM_H
+
+typedef int gpio_num_t;
+
+#endif
@@ -0,0 +1,113 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "lcd/epd_lcd_ssd1680.h"
+#include "ssd1680_emu.h"
+
+/**
+ * cost of epd_panel_clear_display and epd_panel_clear_ram on spi, checked against the emulator.
+ * clear_display after a refresh, same emulator:
+ *   one lcd_data per byte   5004 transactions  5001 data bytes  40032 us spi
+ *   auto write 0x46/0x47       3 transactions     1 data byte      24 us spi
+ * solid color must fill ram by auto write without ram data, a pattern in at most two transactions.
+ */
+
+#define FRAME_SIZE (LCD_H_RES * LCD_V_RES / 8)
+#define CMD_WRITE_RAM 0x24
+#define CMD_WRITE_RAM_RED 0x26
+
+// whole frame of pattern goes in dma transactions of at most 4096 bytes
+#define MAX_PATTERN_TRANSACTIONS 2
+// solid clear is window, counter, auto write and refresh commands only
+#define MAX_SOLID_TRANSACTIONS 24
+
+static int failed;
+
+static bool ram_is(const uint8_t *ram, uint8_t color) {
+    for (int i = 0; i < FRAME_SIZE; i++) {
+        if (ram[i] != color) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * draw a frame of black and white stripes so a clear changes every ram byte
+ */
+static void dirty_panel() {
+    static uint8_t frame[FRAME_SIZE];
+    for (int i = 0; i < FRAME_SIZE; i++) {
+        frame[i] = i & 1 ? 0x00 : 0x5A;
+    }
+    epd_panel_draw_bitmap(0, 0, LCD_H_RES, LCD_V_RES, frame);
+    epd_panel_refresh(true, true);
+    epd_panel_refresh(false, true);
+    ssd1680_emu_reset_stats();
+}
+
+static void check(const char *name, uint8_t color, bool red, bool screen) {
+    const ssd1680_emu_stats_t *s = ssd1680_emu_get_stats();
+    bool solid = color == 0x00 || color == 0xFF;
+    uint32_t ram_cmds = s->cmd_hist[CMD_WRITE_RAM] + s->cmd_hist[CMD_WRITE_RAM_RED];
+    // window, counter and refresh commands of clear are all small parameter transactions
+    uint32_t data_trans = s->transactions - s->cmd_count;
+
+    printf("%-24s %5u transactions %4u commands %6u data bytes %6llu us spi\n",
+           name, s->transactions, s->cmd_count, s->data_bytes, (unsigned long long) s->spi_time_us);
+
+    if (!ram_is(ssd1680_emu_get_ram(), color)) {
+        printf("  b/w ram not 0x%02x\n", color);
+        failed++;
+    }
+    if (red && !ram_is(ssd1680_emu_get_red_ram(), color)) {
+        printf("  red ram not 0x%02x\n", color);
+        failed++;
+    }
+    if (screen && !ram_is(ssd1680_emu_get_screen(), color)) {
+        printf("  screen not 0x%02x\n", color);
+        failed++;
+    }
+    if (solid && (ram_cmds != 0 || s->transactions > MAX_SOLID_TRANSACTIONS)) {
+        printf("  solid clear sent %u ram writes in %u transactions\n", ram_cmds, s->transactions);
+        failed++;
+    }
+    if (!solid && s->data_bytes > FRAME_SIZE * (red ? 2 : 1) + 2 * MAX_SOLID_TRANSACTIONS) {
+        printf("  pattern clear sent %u data bytes\n", s->data_bytes);
+        failed++;
+    }
+    if (!solid && data_trans > MAX_SOLID_TRANSACTIONS + MAX_PATTERN_TRANSACTIONS * (red ? 2 : 1)) {
+        printf("  pattern clear sent %u data transactions\n", data_trans);
+        failed++;
+    }
+    ssd1680_emu_reset_stats();
+}
+
+int main(int argc, char **argv) {
+    ssd1680_emu_reset();
+    epd_panel_driver_init(SPI2_HOST);
+    epd_panel_reset();
+
+    dirty_panel();
+    epd_panel_clear_display(0xFF);
+    check("clear_display white", 0xFF, false, true);
+
+    dirty_panel();
+    epd_panel_clear_display(0x00);
+    check("clear_display black", 0x00, false, true);
+
+    // ping-pong partial compares with red ram, both cleared
+    dirty_panel();
+    epd_panel_clear_ram(0xFF, true);
+    epd_panel_wait_transfer_done();
+    check("clear_ram b/w and red", 0xFF, true, false);
+
+    dirty_panel();
+    epd_panel_clear_ram(0xAA, true);
+    epd_panel_wait_transfer_done();
+    check("clear_ram pattern", 0xAA, true, false);
+
+    epd_panel_del();
+    printf("%d checks failed\n", failed);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,107 @@
+#include <stdio.h>
+
+#include "lcd/epd_lcd_ssd1680.h"
+#include "ssd1680_emu.h"
+
+/**
+ * commands sent by a full / partial / full refresh sequence, like gui task after boot.
+ * only first init after hardware reset does sw reset, a mode change writes lut once
+ * and registers same as before are not sent again.
+ */
+
+#define CMD_SOFT_RESET        0x12
+#define CMD_MASTER_ACTIVATION 0x20
+#define CMD_UPDATE_CONTROL_2  0x22
+#define CMD_WRITE_LUT         0x32
+#define CMD_DISPLAY_OPTION    0x37
+#define CMD_BORDER_WAVEFORM   0x3C
+#define CMD_GATE_VOLTAGE      0x03
+#define CMD_SOURCE_VOLTAGE    0x04
+#define CMD_VCOM              0x2C
+
+typedef struct {
+    const char *name;
+    uint32_t sw_reset;
+    uint32_t lut;
+    uint32_t display_option;
+    uint32_t update_control;
+    uint32_t activation;
+    uint32_t voltage; // 0x03, 0x04 and 0x2C together
+    uint32_t full_refresh;
+    uint32_t partial_refresh;
+} step_t;
+
+static int failed;
+
+static void check_step(const step_t *want) {
+    const ssd1680_emu_stats_t *s = ssd1680_emu_get_stats();
+    const struct {
+        const char *what;
+        uint32_t got, want;
+    } counts[] = {
+            {"sw reset 0x12",         s->cmd_hist[CMD_SOFT_RESET],       want->sw_reset},
+            {"lut 0x32",              s->cmd_hist[CMD_WRITE_LUT],        want->lut},
+            {"display option 0x37",   s->cmd_hist[CMD_DISPLAY_OPTION],   want->display_option},
+            {"border 0x3C",           s->cmd_hist[CMD_BORDER_WAVEFORM],  0},
+            {"update control 2 0x22", s->cmd_hist[CMD_UPDATE_CONTROL_2], want->update_control},
+            {"activation 0x20",       s->cmd_hist[CMD_MASTER_ACTIVATION], want->activation},
+            {"voltage 0x03 0x04 0x2C",
+             s->cmd_hist[CMD_GATE_VOLTAGE] + s->cmd_hist[CMD_SOURCE_VOLTAGE] + s->cmd_hist[CMD_VCOM], want->voltage},
+            {"full refresh",          s->full_refresh,                   want->full_refresh},
+            {"partial refresh",       s->partial_refresh,                want->partial_refresh},
+    };
+
+    printf("%-24s %3u commands %5llu us spi\n", want->name, s->cmd_count, (unsigned long long) s->spi_time_us);
+    for (int i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        if (counts[i].got != counts[i].want) {
+            printf("  %s sent %u times, want %u\n", counts[i].what, counts[i].got, counts[i].want);
+            failed++;
+        }
+    }
+    ssd1680_emu_reset_stats();
+}
+
+int main(int argc, char **argv) {
+    ssd1680_emu_reset();
+    epd_panel_driver_init(SPI2_HOST);
+    epd_panel_reset();
+    ssd1680_emu_reset_stats();
+
+    // first init after hardware reset configures everything, border included
+    epd_panel_refresh(true, true);
+    const ssd1680_emu_stats_t *s = ssd1680_emu_get_stats();
+    printf("%-24s %3u commands %5llu us spi\n", "boot full", s->cmd_count, (unsigned long long) s->spi_time_us);
+    if (s->cmd_hist[CMD_SOFT_RESET] != 1 || s->cmd_hist[CMD_WRITE_LUT] != 1 || s->cmd_hist[CMD_BORDER_WAVEFORM] != 1) {
+        printf("  boot init sent sw reset %u lut %u border %u times, want 1 each\n",
+               s->cmd_hist[CMD_SOFT_RESET], s->cmd_hist[CMD_WRITE_LUT], s->cmd_hist[CMD_BORDER_WAVEFORM]);
+        failed++;
+    }
+    ssd1680_emu_reset_stats();
+
+    // same mode, only activation
+    epd_panel_refresh(true, true);
+    check_step(&(step_t) {"full again", .activation = 1, .full_refresh = 1});
+
+    // mode change: lut, ping-pong option and mode 2 once, partial init refresh then requested one.
+    // gate and source voltage differ between the stock tables, vcom is the same
+    epd_panel_refresh(false, true);
+    check_step(&(step_t) {"full to partial", .lut = 1, .display_option = 1, .update_control = 1,
+            .activation = 2, .voltage = 2, .partial_refresh = 2});
+
+    epd_panel_refresh_area(0, 40, 200, 80, true);
+    epd_panel_refresh_area(16, 100, 120, 140, true);
+    check_step(&(step_t) {"partial x2", .activation = 2, .partial_refresh = 2});
+
+    // colder band scales lut timing only, voltages and option stay. band is applied by init as gui task does
+    epd_panel_set_temperature(0);
+    epd_panel_refresh(false, true);
+    check_step(&(step_t) {"partial colder band", .lut = 1, .activation = 1, .partial_refresh = 1});
+
+    epd_panel_refresh(true, true);
+    check_step(&(step_t) {"partial to full", .lut = 1, .display_option = 1, .update_control = 1,
+            .activation = 1, .voltage = 2, .full_refresh = 1});
+
+    epd_panel_del();
+    printf("%d checks failed\n", failed);
+    return failed ? 1 : 0;
+}
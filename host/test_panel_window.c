@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lcd/epd_lcd_ssd1680.h"
+#include "ssd1680_emu.h"
+
+/**
+ * epd_panel_draw_bitmap of windows inside, unaligned and clipped at panel edge,
+ * check ram of emulator and the spi transactions sent for each.
+ */
+
+#define STRIDE (LCD_H_RES / 8)
+// QUEUED_TRANS_MAX_SIZE of epd_lcd_ssd1680.c
+#define MAX_TRANS_SIZE 4096
+
+typedef struct {
+    int16_t x, y, w, h;
+} window_t;
+
+static const window_t windows[] = {
+        {0,   0,   200, 200}, // whole frame, more than one dma transaction
+        {16,  8,   64,  32},  // aligned
+        {13,  10,  30,  20},  // unaligned x, drawn from byte left of x
+        {5,   60,  3,   1},   // single row, less than a byte
+        {-12, 5,   40,  24},  // clipped left
+        {180, 30,  40,  16},  // clipped right
+        {20,  -3,  24,  10},  // clipped top
+        {40,  190, 16,  20},  // clipped bottom
+        {-20, -20, 240, 240}, // clipped all sides
+        {200, 0,   16,  8},   // outside, nothing sent
+};
+
+static int failed;
+
+#define CHECK(case_index, cond, ...) do { \
+    if (!(cond)) { \
+        printf("window %d: ", case_index); \
+        printf(__VA_ARGS__); \
+        printf("\n"); \
+        failed++; \
+        return; \
+    } \
+} while (0)
+
+static void check_window(int n, const window_t *win) {
+    int wb = (win->w + 7) / 8;
+    uint8_t *bitmap = malloc(wb * win->h);
+    for (int i = 0; i < wb * win->h; i++) {
+        // never 0xFF, so any byte written shows in ram after reset
+        bitmap[i] = (uint8_t) (i * 7 + n) % 0xFF;
+    }
+
+    // ram white, driver forgets ram window so every case sends the same commands
+    epd_panel_reset();
+    ssd1680_emu_reset_stats();
+    epd_panel_draw_bitmap(win->x, win->y, win->x + win->w, win->y + win->h, bitmap);
+    epd_panel_wait_transfer_done();
+
+    uint8_t expect[LCD_V_RES][STRIDE];
+    memset(expect, 0xFF, sizeof(expect));
+    int x_byte = (win->x & ~7) / 8;
+    int x0 = -1, x1 = -1, y0 = -1, y1 = -1;
+    for (int r = 0; r < win->h; r++) {
+        for (int c = 0; c < wb; c++) {
+            int x = x_byte + c;
+            int y = win->y + r;
+            if (x < 0 || x >= STRIDE || y < 0 || y >= LCD_V_RES) {
+                continue;
+            }
+            expect[y][x] = bitmap[r * wb + c];
+            x0 = x0 < 0 || x < x0 ? x : x0;
+            x1 = x > x1 ? x : x1;
+            y0 = y0 < 0 || y < y0 ? y : y0;
+            y1 = y > y1 ? y : y1;
+        }
+    }
+    free(bitmap);
+
+    const uint8_t *ram = ssd1680_emu_get_ram();
+    for (int y = 0; y < LCD_V_RES; y++) {
+        for (int x = 0; x < STRIDE; x++) {
+            CHECK(n, ram[y * STRIDE + x] == expect[y][x], "ram byte %d row %d is 0x%02x, want 0x%02x",
+                  x, y, ram[y * STRIDE + x], expect[y][x]);
+        }
+    }
+
+    size_t count;
+    const ssd1680_emu_trans_t *log = ssd1680_emu_get_trans_log(&count);
+    if (x0 < 0) {
+        CHECK(n, count == 0, "%zu transactions for window outside panel", count);
+        return;
+    }
+
+    // x window and counter by byte, y by row, little endian 9 bit
+    const struct {
+        uint8_t cmd;
+        size_t len;
+        uint8_t param[4];
+    } head[] = {
+            {0x44, 2, {x0, x1}},
+            {0x45, 4, {y0 & 0xFF, y0 >> 8, y1 & 0xFF, y1 >> 8}},
+            {0x4E, 1, {x0}},
+            {0x4F, 2, {y0 & 0xFF, y0 >> 8}},
+    };
+    size_t i = 0;
+    for (int k = 0; k < sizeof(head) / sizeof(head[0]); k++) {
+        CHECK(n, i + 1 < count, "log ends before command 0x%02x", head[k].cmd);
+        CHECK(n, log[i].dc == 0 && log[i].len == 1 && log[i].data[0] == head[k].cmd,
+              "transaction %zu is not command 0x%02x", i, head[k].cmd);
+        i++;
+        CHECK(n, log[i].dc == 1 && log[i].len == head[k].len && memcmp(log[i].data, head[k].param, head[k].len) == 0,
+              "bad parameter of command 0x%02x", head[k].cmd);
+        i++;
+    }
+
+    CHECK(n, i < count && log[i].dc == 0 && log[i].len == 1 && log[i].data[0] == 0x24,
+          "transaction %zu is not write ram", i);
+    i++;
+
+    // window goes out in one dma transaction, split only at the driver max transaction size
+    size_t want = (size_t) (x1 - x0 + 1) * (y1 - y0 + 1);
+    size_t data_trans = count - i;
+    CHECK(n, data_trans == (want + MAX_TRANS_SIZE - 1) / MAX_TRANS_SIZE, "%zu ram data transactions for %zu bytes", data_trans, want);
+    size_t sent = 0;
+    for (; i < count; i++) {
+        CHECK(n, log[i].dc == 1, "command 0x%02x after ram data", log[i].data[0]);
+        sent += log[i].len;
+    }
+    CHECK(n, sent == want, "%zu ram data bytes, want %zu", sent, want);
+}
+
+int main(int argc, char **argv) {
+    ssd1680_emu_reset();
+    epd_panel_driver_init(SPI2_HOST);
+
+    int cases = sizeof(windows) / sizeof(windows[0]);
+    for (int n = 0; n < cases; n++) {
+        check_window(n, &windows[n]);
+    }
+
+    epd_panel_del();
+    printf("%d of %d windows failed\n", failed, cases);
+    return failed ? 1 : 0;
+}
@@ -50,6 +50,9 @@ static const ble_uuid128_t BLE_UUID_CHAR_UART_TX =
         BLE_UUID128_INIT(0x9E, 0xCA, 0xDC, 0x24, 0x0E, 0xE5, 0xA9, 0xE0, 0x93, 0xF3, 0xA3, 0xB5, 0x02, 0x00, 0x40, 0x6E);
 static const ble_uuid128_t BLE_UUID_CHAR_UART_RX =
         BLE_UUID128_INIT(0x9E, 0xCA, 0xDC, 0x24, 0x0E, 0xE5, 0xA9, 0xE0, 0x93, 0xF3, 0xA3, 0xB5, 0x03, 0x00, 0x40, 0x6E);
+// read, gui loop trace frames
+static const ble_uuid128_t BLE_UUID_CHAR_UART_TRACE =
+        BLE_UUID128_INIT(0x9E, 0xCA, 0xDC, 0x24, 0x0E, 0xE5, 0xA9, 0xE0, 0x93, 0xF3, 0xA3, 0xB5, 0x04, 0x00, 0x40, 0x6E);
 
 
 #define BLE_UUID_END 0x0000
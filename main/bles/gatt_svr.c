@@ -14,6 +14,7 @@
 #include "battery.h"
 #include "sht40.h"
 #include "setting.h"
+#include "lcd/gui_trace.h"
 
 #define TAG "BLE_SERVER_SVC"
 
@@ -22,6 +23,8 @@
 #define NOTIFY_THROUGHPUT_PAYLOAD          32
 #define MIN_REQUIRED_MBUF         2 /* Assuming payload of 500Bytes and each mbuf can take 292Bytes.  */
 
+#define GUI_TRACE_FORMAT_VERSION 1
+
 #define BLE_UUID_STR_LEN (37)
 static char ble_uuid_buf[BLE_UUID_STR_LEN];
 
@@ -139,6 +142,11 @@ static const struct ble_gatt_svc_def gatts_test_svcs[] = {
                                         .access_cb = gatt_svr_chr_access_uart,
                                         .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_NOTIFY
                                 },
+                                {
+                                        .uuid = &BLE_UUID_CHAR_UART_TRACE.u,
+                                        .access_cb = gatt_svr_chr_access_uart,
+                                        .flags = BLE_GATT_CHR_F_READ
+                                },
                                 {
                                         0, /* No more characteristics in this service. */
                                 }
@@ -298,6 +306,26 @@ static int gatt_svr_chr_access_environment_info(uint16_t conn_handle, uint16_t a
     }
 }
 
+/**
+ * header version, stage count, frame count, frame size, then packed frames newest first.
+ * all frames are under 512 bytes, long read is done by nimble
+ */
+static int gatt_svr_read_gui_trace(struct os_mbuf *om) {
+    // keep it off the nimble host task stack
+    static gui_trace_frame_t frames[GUI_TRACE_FRAME_COUNT];
+    uint8_t packed[GUI_TRACE_PACKED_FRAME_SIZE];
+
+    uint8_t count = gui_trace_get_frames(frames, GUI_TRACE_FRAME_COUNT);
+    uint8_t header[] = {GUI_TRACE_FORMAT_VERSION, GUI_TRACE_STAGE_COUNT, count, GUI_TRACE_PACKED_FRAME_SIZE};
+    int rc = os_mbuf_append(om, header, sizeof(header));
+    for (uint8_t i = 0; i < count && rc == 0; i++) {
+        uint8_t len = gui_trace_pack_frame(&frames[i], packed);
+        rc = os_mbuf_append(om, packed, len);
+    }
+    ESP_LOGI(TAG, "read gui trace %d frames rc:%d", count, rc);
+    return rc == 0 ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+}
+
 static int gatt_svr_chr_access_uart(uint16_t conn_handle, uint16_t attr_handle,
                                     struct ble_gatt_access_ctxt *ctxt, void *arg) {
 
@@ -336,6 +364,9 @@ static int gatt_svr_chr_access_uart(uint16_t conn_handle, uint16_t attr_handle,
         rc = os_mbuf_append(ctxt->om, gatt_read_buff, read_len);
         ESP_LOGI(TAG, "read uart rx len %d data[0]: %d", read_len, gatt_read_buff[0]);
         return rc;
+    } else if (ctxt->op == BLE_GATT_ACCESS_OP_READ_CHR
+        && ble_uuid_cmp(uuid, &BLE_UUID_CHAR_UART_TRACE.u) == 0) {
+        return gatt_svr_read_gui_trace(ctxt->om);
     } else {
         ble_uuid_to_str(uuid, ble_uuid_buf);
         ESP_LOGW(TAG, "unknown op: %d for uuid: %s", ctxt->op, ble_uuid_buf);
@@ -0,0 +1,325 @@
+#include <stdio.h>
+#include <string.h>
+#include <dirent.h>
+#include <unistd.h>
+#include "esp_log.h"
+#include "esp_spiffs.h"
+#include "sdkconfig.h"
+
+#include "image_cache.h"
+#include "my_file_common.h"
+#include "lcd/dither.h"
+
+#define TAG "image-cache"
+
+#if CONFIG_IMAGE_CACHE_ENABLED
+
+#define IMAGE_CACHE_MAGIC 0x31435046 // "FPC1"
+#define IMAGE_CACHE_ROTATION_COUNT 4
+// 300KB storage holds about 60 frames, more entries than that are evicted
+#define IMAGE_CACHE_MAX_ENTRIES 64
+
+typedef struct {
+    uint32_t magic;
+    uint32_t name_hash;
+    uint32_t src_size;
+    int64_t src_mtime;
+    uint32_t store_seq; // bigger is stored later, use order after boot
+    uint8_t rotation;
+    uint8_t dither_mode;
+    uint16_t image_size;
+} image_cache_header_t;
+
+/**
+ * entry in storage, use order is kept here so a hit does not write flash
+ */
+typedef struct {
+    uint32_t name_hash;
+    uint32_t file_size;
+    uint32_t use_seq; // bigger is used later
+    uint8_t rotation;
+    uint8_t dither_mode;
+} image_cache_entry_t;
+
+static image_cache_entry_t cache_entries[IMAGE_CACHE_MAX_ENTRIES];
+static uint8_t cache_entry_count = 0;
+// last seq given
+static uint32_t cache_seq = 0;
+// storage scanned once after boot
+static bool cache_scanned = false;
+
+static uint32_t name_hash(const char *src_path) {
+    // fnv-1a of file name
+    const char *name = strrchr(src_path, '/');
+    name = name != NULL ? name + 1 : src_path;
+    uint32_t hash = 2166136261u;
+    for (; *name; name++) {
+        hash ^= (uint8_t) *name;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void entry_path(char *path, size_t path_size, uint32_t hash, uint8_t rotation, uint8_t dither_mode) {
+    snprintf(path, path_size, "%s/%08lx_%d%d" IMAGE_CACHE_FILE_EXT, FILE_SERVER_BASE_PATH,
+             (unsigned long) hash, rotation, dither_mode);
+}
+
+static bool is_cache_file(const char *name) {
+    size_t len = strlen(name);
+    size_t ext_len = strlen(IMAGE_CACHE_FILE_EXT);
+    return len > ext_len && strcmp(name + len - ext_len, IMAGE_CACHE_FILE_EXT) == 0;
+}
+
+static bool read_header(const char *path, image_cache_header_t *header) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        return false;
+    }
+    bool ok = fread(header, sizeof(image_cache_header_t), 1, f) == 1 && header->magic == IMAGE_CACHE_MAGIC;
+    fclose(f);
+    return ok;
+}
+
+static int find_entry(uint32_t hash, uint8_t rotation, uint8_t dither_mode) {
+    for (int i = 0; i < cache_entry_count; i++) {
+        if (cache_entries[i].name_hash == hash && cache_entries[i].rotation == rotation
+            && cache_entries[i].dither_mode == dither_mode) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void forget_entry(int index) {
+    cache_entries[index] = cache_entries[--cache_entry_count];
+}
+
+/**
+ * remove entry file and forget it
+ */
+static void remove_entry(int index) {
+    char path[32];
+    image_cache_entry_t *entry = &cache_entries[index];
+    entry_path(path, sizeof(path), entry->name_hash, entry->rotation, entry->dither_mode);
+    unlink(path);
+    forget_entry(index);
+}
+
+static int oldest_entry() {
+    int oldest = -1;
+    for (int i = 0; i < cache_entry_count; i++) {
+        if (oldest < 0 || cache_entries[i].use_seq < cache_entries[oldest].use_seq) {
+            oldest = i;
+        }
+    }
+    return oldest;
+}
+
+/**
+ * list entries in storage once after boot, ordered by store as use is not saved.
+ * broken entries and those over the table are removed
+ */
+static void scan_entries() {
+    if (cache_scanned) {
+        return;
+    }
+    cache_scanned = true;
+
+    DIR *dir = opendir(FILE_SERVER_BASE_PATH "/");
+    if (dir == NULL) {
+        return;
+    }
+    char path[64];
+    struct dirent *dirent;
+    while ((dirent = readdir(dir)) != NULL) {
+        if (dirent->d_type != DT_REG || !is_cache_file(dirent->d_name)) {
+            continue;
+        }
+        snprintf(path, sizeof(path), "%s/%s", FILE_SERVER_BASE_PATH, dirent->d_name);
+        struct stat entry_stat;
+        image_cache_header_t header;
+        if (stat(path, &entry_stat) == -1) {
+            continue;
+        }
+        if (!read_header(path, &header) || cache_entry_count == IMAGE_CACHE_MAX_ENTRIES) {
+            ESP_LOGI(TAG, "remove cache %s", path);
+            unlink(path);
+            continue;
+        }
+        cache_entries[cache_entry_count++] = (image_cache_entry_t) {
+                .name_hash = header.name_hash,
+                .file_size = entry_stat.st_size,
+                .use_seq = header.store_seq,
+                .rotation = header.rotation,
+                .dither_mode = header.dither_mode,
+        };
+        if (header.store_seq > cache_seq) {
+            cache_seq = header.store_seq;
+        }
+    }
+    closedir(dir);
+}
+
+/**
+ * remove least recently used entries till cache takes at most limit bytes and has a free slot
+ */
+static void evict(uint32_t limit) {
+    uint32_t total = 0;
+    for (int i = 0; i < cache_entry_count; i++) {
+        total += cache_entries[i].file_size;
+    }
+    while (cache_entry_count > 0 && (total > limit || cache_entry_count == IMAGE_CACHE_MAX_ENTRIES)) {
+        int oldest = oldest_entry();
+        ESP_LOGI(TAG, "evict %08lx_%d%d, cache %ld bytes over %ld", (unsigned long) cache_entries[oldest].name_hash,
+                 cache_entries[oldest].rotation, cache_entries[oldest].dither_mode, (long) total, (long) limit);
+        total -= cache_entries[oldest].file_size;
+        remove_entry(oldest);
+    }
+}
+
+bool image_cache_load(const char *src_path, const struct stat *src_stat, uint8_t rotation, uint8_t dither_mode,
+                      uint8_t *image, uint16_t image_size) {
+    char path[32];
+    uint32_t hash = name_hash(src_path);
+    entry_path(path, sizeof(path), hash, rotation, dither_mode);
+
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        return false;
+    }
+
+    image_cache_header_t header;
+    bool hit = fread(&header, sizeof(header), 1, f) == 1
+               && header.magic == IMAGE_CACHE_MAGIC
+               && header.name_hash == hash
+               && header.src_size == (uint32_t) src_stat->st_size
+               && header.src_mtime == (int64_t) src_stat->st_mtime
+               && header.rotation == rotation
+               && header.dither_mode == dither_mode
+               && header.image_size == image_size
+               && fread(image, 1, image_size, f) == image_size;
+    fclose(f);
+
+    if (!hit) {
+        // image changed or entry broken
+        ESP_LOGI(TAG, "stale cache %s of %s", path, src_path);
+        unlink(path);
+    }
+
+    // entries not scanned yet are ordered by store at scan
+    int index = cache_scanned ? find_entry(hash, rotation, dither_mode) : -1;
+    if (index >= 0 && hit) {
+        cache_entries[index].use_seq = ++cache_seq;
+    } else if (index >= 0) {
+        forget_entry(index);
+    }
+    return hit;
+}
+
+bool image_cache_contains(const char *src_path, const struct stat *src_stat, uint8_t rotation, uint8_t dither_mode,
+                          uint16_t image_size) {
+    char path[32];
+    image_cache_header_t header;
+    uint32_t hash = name_hash(src_path);
+    entry_path(path, sizeof(path), hash, rotation, dither_mode);
+    return read_header(path, &header)
+           && header.name_hash == hash
+           && header.src_size == (uint32_t) src_stat->st_size
+           && header.src_mtime == (int64_t) src_stat->st_mtime
+           && header.image_size == image_size;
+}
+
+void image_cache_store(const char *src_path, const struct stat *src_stat, uint8_t rotation, uint8_t dither_mode,
+                       const uint8_t *image, uint16_t image_size) {
+    size_t total = 0, used = 0;
+    if (esp_spiffs_info(NULL, &total, &used) != ESP_OK) {
+        return;
+    }
+    uint32_t limit = total / 100 * CONFIG_IMAGE_CACHE_MAX_PERCENT;
+    uint32_t entry_size = sizeof(image_cache_header_t) + image_size;
+    if (entry_size > limit) {
+        return;
+    }
+
+    scan_entries();
+    uint32_t hash = name_hash(src_path);
+    int index = find_entry(hash, rotation, dither_mode);
+    if (index >= 0) {
+        // file is rewritten below
+        forget_entry(index);
+    }
+    evict(limit - entry_size);
+
+    image_cache_header_t header = {
+            .magic = IMAGE_CACHE_MAGIC,
+            .name_hash = hash,
+            .src_size = src_stat->st_size,
+            .src_mtime = src_stat->st_mtime,
+            .store_seq = ++cache_seq,
+            .rotation = rotation,
+            .dither_mode = dither_mode,
+            .image_size = image_size,
+    };
+    char path[32];
+    entry_path(path, sizeof(path), hash, rotation, dither_mode);
+
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) {
+        ESP_LOGW(TAG, "create cache %s failed", path);
+        return;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 && fwrite(image, 1, image_size, f) == image_size;
+    ok = fclose(f) == 0 && ok;
+    if (!ok) {
+        // storage full, no half entry left
+        ESP_LOGW(TAG, "write cache %s failed", path);
+        unlink(path);
+        return;
+    }
+
+    cache_entries[cache_entry_count++] = (image_cache_entry_t) {
+            .name_hash = hash,
+            .file_size = entry_size,
+            .use_seq = header.store_seq,
+            .rotation = rotation,
+            .dither_mode = dither_mode,
+    };
+    ESP_LOGI(TAG, "cache %s as %s", src_path, path);
+}
+
+void image_cache_remove(const char *src_path) {
+    char path[32];
+    uint32_t hash = name_hash(src_path);
+    for (uint8_t rotation = 0; rotation < IMAGE_CACHE_ROTATION_COUNT; rotation++) {
+        for (uint8_t dither_mode = 0; dither_mode < DITHER_MODE_COUNT; dither_mode++) {
+            entry_path(path, sizeof(path), hash, rotation, dither_mode);
+            unlink(path);
+            int index = find_entry(hash, rotation, dither_mode);
+            if (index >= 0) {
+                forget_entry(index);
+            }
+        }
+    }
+}
+
+#else
+
+bool image_cache_load(const char *src_path, const struct stat *src_stat, uint8_t rotation, uint8_t dither_mode,
+                      uint8_t *image, uint16_t image_size) {
+    return false;
+}
+
+bool image_cache_contains(const char *src_path, const struct stat *src_stat, uint8_t rotation, uint8_t dither_mode,
+                          uint16_t image_size) {
+    return false;
+}
+
+void image_cache_store(const char *src_path, const struct stat *src_stat, uint8_t rotation, uint8_t dither_mode,
+                       const uint8_t *image, uint16_t image_size) {
+}
+
+void image_cache_remove(const char *src_path) {
+}
+
+#endif
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/stat.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * frame buffers of drawn image files kept in storage next to the images.
+ * an entry is one image in one rotation and dither mode, valid while size and mtime of the image stay same.
+ * least recently used entries are removed when cache grows over CONFIG_IMAGE_CACHE_MAX_PERCENT of storage.
+ * use order is kept in ram, a hit only reads flash. after boot entries are ordered by when they were stored.
+ */
+
+// cache files have this extension so image list skips them
+#define IMAGE_CACHE_FILE_EXT ".fbc"
+
+/**
+ * read cached frame of src_path into image, false if no valid entry
+ */
+bool image_cache_load(const char *src_path, const struct stat *src_stat, uint8_t rotation, uint8_t dither_mode,
+                      uint8_t *image, uint16_t image_size);
+
+/**
+ * whether a valid entry of src_path exists, entry is not read nor marked used
+ */
+bool image_cache_contains(const char *src_path, const struct stat *src_stat, uint8_t rotation, uint8_t dither_mode,
+                          uint16_t image_size);
+
+void image_cache_store(const char *src_path, const struct stat *src_stat, uint8_t rotation, uint8_t dither_mode,
+                       const uint8_t *image, uint16_t image_size);
+
+/**
+ * remove entries of src_path in all rotations and dither modes
+ */
+void image_cache_remove(const char *src_path);
+
+#ifdef __cplusplus
+}
+#endif
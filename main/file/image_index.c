@@ -0,0 +1,333 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <dirent.h>
+#include <unistd.h>
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include "image_index.h"
+#include "my_file_common.h"
+#include "lcd/bmp.h"
+#include "lcd/jpg.h"
+#include "lcd/epi.h"
+
+#define TAG "image-index"
+
+#define IMAGE_INDEX_MAGIC 0x31584449 // "IDX1"
+#define IMAGE_INDEX_PATH FILE_SERVER_BASE_PATH "/" IMAGE_INDEX_FILE_NAME
+
+typedef struct {
+    uint32_t magic;
+    uint16_t count;
+    uint16_t entry_size; // sizeof(image_index_entry_t) when written, index of other layout is rebuilt
+} image_index_header_t;
+
+#define ENTRY_OFFSET(index) (sizeof(image_index_header_t) + (long) (index) * sizeof(image_index_entry_t))
+
+// gui task draws from index while ble upload task appends to it
+static SemaphoreHandle_t index_lock = NULL;
+
+static void index_lock_take() {
+    if (index_lock != NULL) {
+        xSemaphoreTake(index_lock, portMAX_DELAY);
+    }
+}
+
+static void index_lock_give() {
+    if (index_lock != NULL) {
+        xSemaphoreGive(index_lock);
+    }
+}
+
+static const char *base_name(const char *path) {
+    const char *name = strrchr(path, '/');
+    return name != NULL ? name + 1 : path;
+}
+
+static bool has_ext(const char *name, const char *ext) {
+    size_t len = strlen(name), ext_len = strlen(ext);
+    return len > ext_len && strcasecmp(name + len - ext_len, ext) == 0;
+}
+
+static bool read_header(FILE *f, image_index_header_t *header) {
+    fseek(f, 0, SEEK_SET);
+    return fread(header, sizeof(image_index_header_t), 1, f) == 1
+           && header->magic == IMAGE_INDEX_MAGIC
+           && header->entry_size == sizeof(image_index_entry_t);
+}
+
+static bool write_header(FILE *f, uint16_t count) {
+    image_index_header_t header = {
+            .magic = IMAGE_INDEX_MAGIC,
+            .count = count,
+            .entry_size = sizeof(image_index_entry_t),
+    };
+    fseek(f, 0, SEEK_SET);
+    return fwrite(&header, sizeof(header), 1, f) == 1;
+}
+
+/**
+ * stat and read size of image at path, false if it should not be listed
+ */
+static bool read_image_entry(const char *path, image_index_entry_t *entry) {
+    const char *name = base_name(path);
+    if (strlen(name) >= IMAGE_INDEX_NAME_LEN) {
+        return false;
+    }
+    image_index_type_t type;
+    if (has_ext(name, ".bmp")) {
+        type = IMAGE_INDEX_TYPE_BMP;
+    } else if (has_ext(name, ".jpg")) {
+        type = IMAGE_INDEX_TYPE_JPG;
+    } else if (has_ext(name, ".epi")) {
+        type = IMAGE_INDEX_TYPE_EPI;
+    } else {
+        return false;
+    }
+
+    struct stat file_stat;
+    if (stat(path, &file_stat) == -1 || file_stat.st_size > MAX_FILE_SIZE) {
+        return false;
+    }
+
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        return false;
+    }
+    bool ok;
+    memset(entry, 0, sizeof(image_index_entry_t));
+    if (type == IMAGE_INDEX_TYPE_BMP) {
+        uint8_t buff[sizeof(bmp_header)];
+        bmp_header header;
+        ok = fread(buff, sizeof(buff), 1, f) == 1 && bmp_header_read(&header, buff, sizeof(buff)) == BMP_OK;
+        if (ok) {
+            entry->width = header.biWidth;
+            entry->height = abs(header.biHeight);
+        }
+    } else if (type == IMAGE_INDEX_TYPE_EPI) {
+        uint8_t buff[sizeof(epi_header_t)];
+        epi_header_t header;
+        ok = fread(buff, sizeof(buff), 1, f) == 1 && epi_header_read(&header, buff, sizeof(buff)) == EPI_OK;
+        if (ok) {
+            entry->width = header.width;
+            entry->height = header.height;
+        }
+    } else {
+        jpg_t header;
+        ok = jpg_header_read_file(&header, f) == JPG_OK;
+        if (ok) {
+            entry->width = header.width;
+            entry->height = header.height;
+        }
+    }
+    fclose(f);
+    if (!ok) {
+        ESP_LOGW(TAG, "skip %s, bad header", path);
+        return false;
+    }
+
+    strcpy(entry->name, name);
+    entry->size = file_stat.st_size;
+    entry->mtime = file_stat.st_mtime;
+    entry->type = type;
+    return true;
+}
+
+/**
+ * position of name in index, -1 if not listed
+ */
+static int32_t find_entry(FILE *f, uint16_t count, const char *name, image_index_entry_t *entry) {
+    fseek(f, ENTRY_OFFSET(0), SEEK_SET);
+    for (uint16_t i = 0; i < count; i++) {
+        if (fread(entry, sizeof(image_index_entry_t), 1, f) != 1) {
+            break;
+        }
+        if (strncmp(entry->name, name, IMAGE_INDEX_NAME_LEN) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static uint16_t rebuild() {
+    char path[64];
+    image_index_entry_t entry;
+    uint16_t count = 0;
+
+    FILE *f = fopen(IMAGE_INDEX_PATH, "wb");
+    if (f == NULL) {
+        ESP_LOGE(TAG, "create %s failed", IMAGE_INDEX_PATH);
+        return 0;
+    }
+    write_header(f, 0);
+
+    DIR *dir = opendir(FILE_SERVER_BASE_PATH "/");
+    if (dir != NULL) {
+        struct dirent *dir_entry;
+        while ((dir_entry = readdir(dir)) != NULL && count < UINT16_MAX) {
+            if (dir_entry->d_type != DT_REG) {
+                continue;
+            }
+            snprintf(path, sizeof(path), "%s/%s", FILE_SERVER_BASE_PATH, dir_entry->d_name);
+            if (!read_image_entry(path, &entry)) {
+                continue;
+            }
+            if (fwrite(&entry, sizeof(entry), 1, f) != 1) {
+                break;
+            }
+            count++;
+        }
+        closedir(dir);
+    }
+
+    bool ok = write_header(f, count);
+    ok = fclose(f) == 0 && ok;
+    if (!ok) {
+        // storage full, next load walks dir again
+        ESP_LOGE(TAG, "write %s failed", IMAGE_INDEX_PATH);
+        unlink(IMAGE_INDEX_PATH);
+    }
+    ESP_LOGI(TAG, "rebuild index, %d images", count);
+    return count;
+}
+
+void image_index_init() {
+    if (index_lock == NULL) {
+        index_lock = xSemaphoreCreateMutex();
+    }
+}
+
+uint16_t image_index_load() {
+    index_lock_take();
+    image_index_header_t header;
+    bool ok = false;
+    FILE *f = fopen(IMAGE_INDEX_PATH, "rb");
+    if (f != NULL) {
+        // entries cut by a power loss while writing
+        ok = read_header(f, &header) && fseek(f, 0, SEEK_END) == 0 && ftell(f) >= ENTRY_OFFSET(header.count);
+        fclose(f);
+    }
+    uint16_t count = ok ? header.count : rebuild();
+    index_lock_give();
+    return count;
+}
+
+uint16_t image_index_count() {
+    index_lock_take();
+    image_index_header_t header;
+    uint16_t count = 0;
+    FILE *f = fopen(IMAGE_INDEX_PATH, "rb");
+    if (f != NULL) {
+        if (read_header(f, &header)) {
+            count = header.count;
+        }
+        fclose(f);
+    }
+    index_lock_give();
+    return count;
+}
+
+bool image_index_get(uint16_t index, image_index_entry_t *entry) {
+    index_lock_take();
+    image_index_header_t header;
+    bool ok = false;
+    FILE *f = fopen(IMAGE_INDEX_PATH, "rb");
+    if (f != NULL) {
+        ok = read_header(f, &header)
+             && index < header.count
+             && fseek(f, ENTRY_OFFSET(index), SEEK_SET) == 0
+             && fread(entry, sizeof(image_index_entry_t), 1, f) == 1;
+        fclose(f);
+    }
+    index_lock_give();
+    return ok;
+}
+
+void image_index_entry_path(const image_index_entry_t *entry, char *path, size_t path_size) {
+    snprintf(path, path_size, "%s/%.*s", FILE_SERVER_BASE_PATH, IMAGE_INDEX_NAME_LEN, entry->name);
+}
+
+void image_index_entry_stat(const image_index_entry_t *entry, struct stat *entry_stat) {
+    memset(entry_stat, 0, sizeof(struct stat));
+    entry_stat->st_size = entry->size;
+    entry_stat->st_mtime = entry->mtime;
+}
+
+bool image_index_add(const char *path) {
+    image_index_entry_t entry, listed;
+    if (!read_image_entry(path, &entry)) {
+        ESP_LOGW(TAG, "not a valid image %s", path);
+        return false;
+    }
+
+    index_lock_take();
+    image_index_header_t header;
+    bool ok = false;
+    FILE *f = fopen(IMAGE_INDEX_PATH, "r+b");
+    if (f != NULL && read_header(f, &header)) {
+        int32_t index = find_entry(f, header.count, entry.name, &listed);
+        if (index >= 0) {
+            // written again under same name, size or mtime changed
+            ok = fseek(f, ENTRY_OFFSET(index), SEEK_SET) == 0 && fwrite(&entry, sizeof(entry), 1, f) == 1;
+        } else {
+            ok = fseek(f, ENTRY_OFFSET(header.count), SEEK_SET) == 0
+                 && fwrite(&entry, sizeof(entry), 1, f) == 1
+                 && write_header(f, header.count + 1);
+        }
+        ok = fclose(f) == 0 && ok;
+    } else {
+        if (f != NULL) {
+            fclose(f);
+        }
+        // no index yet, image is already in dir
+        rebuild();
+        ok = true;
+    }
+    index_lock_give();
+    ESP_LOGI(TAG, "add %s %dx%d", path, entry.width, entry.height);
+    return ok;
+}
+
+bool image_index_remove(const char *path) {
+    const char *name = base_name(path);
+    image_index_entry_t entry;
+
+    index_lock_take();
+    image_index_header_t header;
+    bool ok = false;
+    FILE *f = fopen(IMAGE_INDEX_PATH, "r+b");
+    if (f != NULL && read_header(f, &header)) {
+        int32_t index = find_entry(f, header.count, name, &entry);
+        if (index >= 0) {
+            // keep upload order, tail after count is left and overwritten by next add
+            ok = true;
+            for (uint16_t i = index + 1; i < header.count && ok; i++) {
+                ok = fseek(f, ENTRY_OFFSET(i), SEEK_SET) == 0
+                     && fread(&entry, sizeof(entry), 1, f) == 1
+                     && fseek(f, ENTRY_OFFSET(i - 1), SEEK_SET) == 0
+                     && fwrite(&entry, sizeof(entry), 1, f) == 1;
+            }
+            ok = ok && write_header(f, header.count - 1);
+        }
+        ok = fclose(f) == 0 && ok;
+        if (!ok && index >= 0) {
+            // half moved, walk dir next load
+            unlink(IMAGE_INDEX_PATH);
+        }
+    } else if (f != NULL) {
+        fclose(f);
+    }
+    index_lock_give();
+    ESP_LOGI(TAG, "remove %s %s", path, ok ? "ok" : "not listed");
+    return ok;
+}
+
+uint16_t image_index_rebuild() {
+    index_lock_take();
+    uint16_t count = rebuild();
+    index_lock_give();
+    return count;
+}
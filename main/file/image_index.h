@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/stat.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * list of valid images in storage kept in a file, so image page finds the i-th image by one seek
+ * instead of walking the dir and stat every file on each draw.
+ * updated when an image is uploaded or deleted, rebuilt by one dir walk when missing or broken.
+ * storage must be mounted when calling these.
+ */
+
+#define IMAGE_INDEX_FILE_NAME "images.idx"
+
+// name without dir, same as CONFIG_SPIFFS_OBJ_NAME_LEN
+#define IMAGE_INDEX_NAME_LEN 32
+
+typedef enum {
+    IMAGE_INDEX_TYPE_BMP = 0,
+    IMAGE_INDEX_TYPE_JPG,
+    IMAGE_INDEX_TYPE_EPI,
+} image_index_type_t;
+
+typedef struct {
+    char name[IMAGE_INDEX_NAME_LEN];
+    uint32_t size;
+    int64_t mtime;
+    uint16_t width;
+    uint16_t height;
+    uint8_t type; // image_index_type_t
+    uint8_t reserved[3];
+} image_index_entry_t;
+
+/**
+ * create lock, before gui and ble upload tasks start
+ */
+void image_index_init();
+
+/**
+ * check index file, rebuild it from dir if missing or broken. returns image count
+ */
+uint16_t image_index_load();
+
+uint16_t image_index_count();
+
+/**
+ * entry at position index in upload order, false if out of range
+ */
+bool image_index_get(uint16_t index, image_index_entry_t *entry);
+
+/**
+ * full path of entry, and stat the image cache is keyed by
+ */
+void image_index_entry_path(const image_index_entry_t *entry, char *path, size_t path_size);
+
+void image_index_entry_stat(const image_index_entry_t *entry, struct stat *entry_stat);
+
+/**
+ * append image file at path, ignored if not a valid image or already listed
+ */
+bool image_index_add(const char *path);
+
+/**
+ * drop image file at path, later entries move up by one
+ */
+bool image_index_remove(const char *path);
+
+/**
+ * walk dir and write index again. returns image count
+ */
+uint16_t image_index_rebuild();
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "sdkconfig.h"
+
+#include "image_prefetch.h"
+#include "lcd/epd_lcd_ssd1680.h"
+
+#define TAG "image-prefetch"
+
+#if CONFIG_IMAGE_PREFETCH_ENABLED
+
+#define PREFETCH_TASK_STACK_SIZE 4096
+
+typedef struct {
+    char path[64];
+    uint32_t size;
+    int64_t mtime;
+    uint8_t rotation;
+    uint8_t dither_mode;
+} prefetch_key_t;
+
+static prefetch_key_t prefetch_key;
+static image_prefetch_draw_fn prefetch_draw_fn = NULL;
+
+// spare frame, kept between prefetches till stop
+static uint8_t *prefetch_image = NULL;
+static uint16_t prefetch_image_size = 0;
+
+// written by prefetch task only while running, read by gui task after join
+static bool prefetch_ready = false;
+
+static bool prefetch_running = false;
+// given by prefetch task when it ends
+static SemaphoreHandle_t prefetch_done = NULL;
+
+static void make_key(prefetch_key_t *key, const char *path, const struct stat *src_stat, uint8_t rotation,
+                     dither_mode_t dither_mode) {
+    memset(key, 0, sizeof(prefetch_key_t));
+    snprintf(key->path, sizeof(key->path), "%s", path);
+    key->size = src_stat->st_size;
+    key->mtime = src_stat->st_mtime;
+    key->rotation = rotation;
+    key->dither_mode = dither_mode;
+}
+
+static void prefetch_task_entry(void *arg) {
+    epd_paint_t paint;
+    epd_paint_init(&paint, prefetch_image, LCD_H_RES, LCD_V_RES, prefetch_key.rotation);
+    epd_paint_clear(&paint, 0);
+    prefetch_ready = prefetch_draw_fn(&paint, prefetch_key.path, prefetch_key.dither_mode);
+    ESP_LOGI(TAG, "prefetch %s %s", prefetch_key.path, prefetch_ready ? "done" : "failed");
+
+    xSemaphoreGive(prefetch_done);
+    vTaskDelete(NULL);
+}
+
+/**
+ * wait at most ticks for running prefetch task, a decode in progress is not broken off.
+ * true if no task is running after it
+ */
+static bool join(TickType_t ticks) {
+    if (prefetch_running && xSemaphoreTake(prefetch_done, ticks) == pdTRUE) {
+        prefetch_running = false;
+    }
+    return !prefetch_running;
+}
+
+void image_prefetch_start(const char *path, const struct stat *src_stat, uint8_t rotation, dither_mode_t dither_mode,
+                          image_prefetch_draw_fn draw_fn) {
+    if (!join(0)) {
+        // busy with an image not wanted any more, gui is not held for it
+        return;
+    }
+    prefetch_key_t key;
+    make_key(&key, path, src_stat, rotation, dither_mode);
+    if (prefetch_ready && memcmp(&key, &prefetch_key, sizeof(key)) == 0) {
+        return;
+    }
+    prefetch_ready = false;
+
+    uint16_t image_size = LCD_H_RES / 8 * LCD_V_RES;
+    size_t free_size = heap_caps_get_free_size(MALLOC_CAP_DMA);
+    size_t need_size = CONFIG_IMAGE_PREFETCH_MIN_FREE_HEAP + (prefetch_image == NULL ? image_size : 0);
+    if (free_size < need_size) {
+        ESP_LOGW(TAG, "skip prefetch %s, free heap %d", path, (int) free_size);
+        image_prefetch_stop();
+        return;
+    }
+    if (prefetch_image == NULL) {
+        prefetch_image = heap_caps_malloc(image_size, MALLOC_CAP_DMA);
+        if (prefetch_image == NULL) {
+            return;
+        }
+        prefetch_image_size = image_size;
+    }
+    if (prefetch_done == NULL) {
+        prefetch_done = xSemaphoreCreateBinary();
+        if (prefetch_done == NULL) {
+            return;
+        }
+    }
+
+    prefetch_key = key;
+    prefetch_draw_fn = draw_fn;
+    // below gui task, decodes while gui waits for panel
+    if (xTaskCreate(prefetch_task_entry, "img_prefetch", PREFETCH_TASK_STACK_SIZE, NULL,
+                    tskIDLE_PRIORITY, NULL) != pdPASS) {
+        ESP_LOGW(TAG, "create prefetch task failed");
+        return;
+    }
+    prefetch_running = true;
+}
+
+bool image_prefetch_take(const char *path, const struct stat *src_stat, uint8_t rotation, dither_mode_t dither_mode,
+                         uint8_t *image, uint16_t image_size) {
+    if (!prefetch_running && !prefetch_ready) {
+        return false;
+    }
+    prefetch_key_t key;
+    make_key(&key, path, src_stat, rotation, dither_mode);
+    if (memcmp(&key, &prefetch_key, sizeof(key)) != 0 || image_size != prefetch_image_size) {
+        return false;
+    }
+    // still decoding, rest of it is shorter than a decode from start
+    join(portMAX_DELAY);
+    if (!prefetch_ready) {
+        return false;
+    }
+    memcpy(image, prefetch_image, image_size);
+    // frame is in use now, next image prefetches again
+    prefetch_ready = false;
+    return true;
+}
+
+void image_prefetch_stop() {
+    join(portMAX_DELAY);
+    prefetch_ready = false;
+    free(prefetch_image);
+    prefetch_image = NULL;
+    prefetch_image_size = 0;
+}
+
+#else
+
+void image_prefetch_start(const char *path, const struct stat *src_stat, uint8_t rotation, dither_mode_t dither_mode,
+                          image_prefetch_draw_fn draw_fn) {
+}
+
+bool image_prefetch_take(const char *path, const struct stat *src_stat, uint8_t rotation, dither_mode_t dither_mode,
+                         uint8_t *image, uint16_t image_size) {
+    return false;
+}
+
+void image_prefetch_stop() {
+}
+
+#endif
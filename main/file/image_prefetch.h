@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/stat.h>
+#include "lcd/epdpaint.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * decodes the image a key press likely shows next into a spare frame buffer, in a low priority task
+ * that runs while gui task waits for panel refresh. a hit makes next draw a memcpy.
+ * only one image is prefetched at a time, all calls are from gui task.
+ */
+
+/**
+ * draw image file at path into epd_paint, false if it can not be read
+ */
+typedef bool (*image_prefetch_draw_fn)(epd_paint_t *epd_paint, const char *path, dither_mode_t dither_mode);
+
+/**
+ * start decoding path in background. skipped when free heap is low
+ * or an earlier prefetch is still running.
+ */
+void image_prefetch_start(const char *path, const struct stat *src_stat, uint8_t rotation, dither_mode_t dither_mode,
+                          image_prefetch_draw_fn draw_fn);
+
+/**
+ * copy prefetched frame of path into image, waits if it is still being decoded. false if not prefetched
+ */
+bool image_prefetch_take(const char *path, const struct stat *src_stat, uint8_t rotation, dither_mode_t dither_mode,
+                         uint8_t *image, uint16_t image_size);
+
+/**
+ * wait for running prefetch and free the spare buffer, before storage unmount or deep sleep
+ */
+void image_prefetch_stop();
+
+#ifdef __cplusplus
+}
+#endif
@@ -2,6 +2,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "esp_log.h"
 #include "common_utils.h"
 
@@ -34,8 +35,10 @@ enum bmp_error bmp_header_read(bmp_header *header, uint8_t *data, uint16_t data_
         }
 
         if (bmpHeader->biBitCount == 1 || bmpHeader->biBitCount == 4 || bmpHeader->biBitCount == 8) {
-            int bmiColorsCount = (bmpHeader->bfOffBits - 14 - bmpHeader->biSize) / sizeof(RGBQUAD);
-            assert(bmiColorsCount == 1 << bmpHeader->biBitCount);
+            // biClrUsed may leave palette shorter than 1 << biBitCount, bmp_palette_count clamps it
+            if (bmp_palette_count(bmpHeader) == 0) {
+                return BMP_INVALID_LUT_SIZE;
+            }
         } else if (bmpHeader->biCompression == BI_BITFIELDS) {
             assert(bmpHeader->bfOffBits - 14 - bmpHeader->biSize == sizeof(RGBQUAD_COLOR_MASK));
         }
@@ -116,6 +119,31 @@ void bmp_get_pixel(pixel_color *out_color, bmp_img_common *bmp_img, uint16_t x,
                             x, y);
 }
 
+int bmp_palette_count(const bmp_header *header) {
+    int count = ((int) header->bfOffBits - 14 - (int) header->biSize) / (int) sizeof(RGBQUAD);
+    if (count <= 0 || header->biBitCount > 8) {
+        return 0;
+    }
+    return min(count, 1 << header->biBitCount);
+}
+
+bool bmp_is_black_white(const bmp_header *header, const RGBQUAD *colors, int color_count, bool *one_is_white) {
+    if (header->biBitCount != 1 || colors == NULL || color_count < 2) {
+        return false;
+    }
+    for (uint8_t i = 0; i < 2; i++) {
+        if (colors[i].red != colors[i].green || colors[i].green != colors[i].blue
+            || (colors[i].red != 0x00 && colors[i].red != 0xff)) {
+            return false;
+        }
+    }
+    if (colors[0].red == colors[1].red) {
+        return false;
+    }
+    *one_is_white = colors[1].red == 0xff;
+    return true;
+}
+
 enum bmp_error bmp_header_read_file(bmp_img_file_common *bmp_img, FILE *img_file) {
     if (img_file == NULL) {
         return BMP_FILE_NOT_OPENED;
@@ -225,4 +253,124 @@ void bmp_file_free(bmp_img_file_common *bmp_img) {
         free(bmp_img->color_data);
         bmp_img->color_data = NULL;
     }
-}
\ No newline at end of file
+}
+// same weights as bgr_to_gray, 30% 59% 11% in 1/256
+static inline uint8_t rgb_to_gray(uint8_t r, uint8_t g, uint8_t b) {
+    return (r * 77 + g * 151 + b * 28) >> 8;
+}
+
+enum bmp_error bmp_band_reader_init(bmp_band_reader_t *reader, FILE *img_file, uint16_t max_band_bytes) {
+    memset(reader, 0, sizeof(bmp_band_reader_t));
+    enum bmp_error err = bmp_header_read_file(&reader->img, img_file);
+    if (err != BMP_OK) {
+        return err;
+    }
+
+    bmp_header *header = &reader->img.img_header;
+    reader->pad_line_byte = ((header->biWidth * header->biBitCount + 31) & ~31) >> 3;
+
+    // lut and masks follow the info header, which may be longer than 40
+    const uint8_t *extra = reader->img.color_data == NULL ? NULL
+                                                          : reader->img.color_data + (header->biSize - 40);
+    if (header->biBitCount <= 8) {
+        // palette may be shorter than 1 << biBitCount when biClrUsed is set
+        int color_count = bmp_palette_count(header);
+        if (extra == NULL || color_count == 0) {
+            return BMP_INVALID_LUT_SIZE;
+        }
+        const RGBQUAD *colors = (const RGBQUAD *) extra;
+        reader->black_white = bmp_is_black_white(header, colors, color_count, &reader->one_is_white);
+        // index past palette is black, gray_lut is zeroed by memset above
+        for (uint16_t i = 0; i < color_count; i++) {
+            reader->gray_lut[i] = rgb_to_gray(colors[i].red, colors[i].green, colors[i].blue);
+        }
+    } else if (header->biBitCount == 16 && header->biCompression == BI_BITFIELDS && extra != NULL) {
+        // masks are red green blue in file
+        uint32_t green_mask;
+        memcpy(&green_mask, extra + 4, sizeof(green_mask));
+        reader->rgb565 = green_mask == 0x07e0;
+    }
+    // all in lut now, free before band buffer is taken
+    free(reader->img.color_data);
+    reader->img.color_data = NULL;
+
+    uint16_t lines = max(max_band_bytes / reader->pad_line_byte, 1);
+    lines = min(lines, abs(header->biHeight));
+    reader->img.data_buff = malloc(lines * reader->pad_line_byte);
+    if (reader->img.data_buff == NULL) {
+        return BMP_ERROR;
+    }
+    reader->img.data_buff_size = lines * reader->pad_line_byte;
+    return BMP_OK;
+}
+
+const uint8_t *bmp_band_reader_get_line(bmp_band_reader_t *reader, uint16_t y, FILE *img_file) {
+    bmp_img_file_common *img = &reader->img;
+    if (y < img->data_start_y || y >= img->data_end_y) {
+        uint16_t lines = min(abs(img->img_header.biHeight) - y, img->data_buff_size / reader->pad_line_byte);
+        // bottom up band is stored reversed, a short read would shift all rows
+        if (bmp_read_file_lines(img, y, lines, img_file) != lines * reader->pad_line_byte) {
+            img->data_end_y = img->data_start_y;
+            return NULL;
+        }
+    }
+
+    uint16_t row = img->img_header.biHeight < 0 ? (y - img->data_start_y) : (img->data_end_y - y - 1);
+    return img->data_buff + row * reader->pad_line_byte;
+}
+
+void bmp_band_reader_line_to_gray(const bmp_band_reader_t *reader, const uint8_t *line, uint16_t x, uint16_t width,
+                                  uint8_t *gray) {
+    const uint8_t *lut = reader->gray_lut;
+    uint16_t end_x = x + width;
+    switch (reader->img.img_header.biBitCount) {
+        case 1:
+            for (uint16_t i = x; i < end_x; i++) {
+                *gray++ = lut[(line[i >> 3] >> (7 - (i & 7))) & 0x01];
+            }
+            break;
+        case 4:
+            for (uint16_t i = x; i < end_x; i++) {
+                *gray++ = lut[(line[i >> 1] >> ((i & 1) ? 0 : 4)) & 0x0f];
+            }
+            break;
+        case 8:
+            for (uint16_t i = x; i < end_x; i++) {
+                *gray++ = lut[line[i]];
+            }
+            break;
+        case 16:
+            for (const uint8_t *p = line + x * 2; p < line + end_x * 2; p += 2) {
+                uint16_t v = p[0] | (p[1] << 8);
+                uint8_t r, g, b = v & 0x1f;
+                if (reader->rgb565) {
+                    r = v >> 11;
+                    g = (v >> 5) & 0x3f;
+                    g = (g << 2) | (g >> 4);
+                } else {
+                    r = (v >> 10) & 0x1f;
+                    g = (v >> 5) & 0x1f;
+                    g = (g << 3) | (g >> 2);
+                }
+                *gray++ = rgb_to_gray((r << 3) | (r >> 2), g, (b << 3) | (b >> 2));
+            }
+            break;
+        case 24:
+            for (const uint8_t *p = line + x * 3; p < line + end_x * 3; p += 3) {
+                *gray++ = rgb_to_gray(p[2], p[1], p[0]);
+            }
+            break;
+        case 32:
+            for (const uint8_t *p = line + x * 4; p < line + end_x * 4; p += 4) {
+                *gray++ = rgb_to_gray(p[2], p[1], p[0]);
+            }
+            break;
+        default:
+            memset(gray, 0xff, width);
+            break;
+    }
+}
+
+void bmp_band_reader_free(bmp_band_reader_t *reader) {
+    bmp_file_free(&reader->img);
+}
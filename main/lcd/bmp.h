@@ -101,6 +101,22 @@ typedef struct {
     uint16_t data_end_y; // 数据buff end_y (不包含)
 } __attribute__((packed)) bmp_img_file_common;
 
+// band buffer of bmp_band_reader_init is cut to rows fit in this, at least one row
+#define BMP_BAND_MAX_BYTES 640
+
+/**
+ * reads a file by bands of whole rows and gives rows as gray,
+ * palette and bit masks are turned into lut at init so only the band buffer is kept in heap.
+ */
+typedef struct {
+    bmp_img_file_common img;
+    uint16_t pad_line_byte;
+    bool rgb565; // 16 bit bitfields 565, else 555
+    bool black_white; // 1 bit with pure black and white palette, rows can be copied as frame buffer bits
+    bool one_is_white; // bit 1 is white when black_white
+    uint8_t gray_lut[256]; // palette index to gray for 1 4 8 bit
+} bmp_band_reader_t;
+
 //    bfOffBits - 14 - biSize
 //    RGBQUAD 彩色表lut // 1、4、8、16 才有
 //    pColor = ((LPSTR) pBitmapInfo + (uint16_t) (pBitmapInfo->bmiHeader.biSize))
@@ -127,12 +143,40 @@ void bmp_get_pixel(pixel_color *out_color, bmp_img_common *bmp_img, uint16_t x,
 
 enum bmp_error bmp_img_read(bmp_img_24 *, const char *);
 
+/**
+ * entries of palette between info header and bfOffBits, at most 1 << biBitCount, 0 if none
+ */
+int bmp_palette_count(const bmp_header *header);
+
+/**
+ * 1 bit image whose palette is pure black and white, rows of it are frame buffer bits as they are
+ * or inverted when one_is_white is false. color_count is entries in colors
+ */
+bool bmp_is_black_white(const bmp_header *header, const RGBQUAD *colors, int color_count, bool *one_is_white);
+
 // FILE
 
 enum bmp_error bmp_header_read_file(bmp_img_file_common *bmp_img, FILE *img_file);
 
 enum bmp_error bmp_file_get_pixel(pixel_color *out_color, bmp_img_file_common *bmp_img, uint16_t x, uint16_t y, FILE *img_file);
 
+int bmp_read_file_lines(bmp_img_file_common *bmp_img, uint16_t start_y, uint16_t lines, FILE *img_file);
+
 void bmp_file_free(bmp_img_file_common *bmp_img);
 
+enum bmp_error bmp_band_reader_init(bmp_band_reader_t *reader, FILE *img_file, uint16_t max_band_bytes);
+
+/**
+ * raw data of row y (top down), reads next band from file when y is not in buffer, NULL on read error
+ */
+const uint8_t *bmp_band_reader_get_line(bmp_band_reader_t *reader, uint16_t y, FILE *img_file);
+
+/**
+ * gray of pixels [x, x + width) of a raw row
+ */
+void bmp_band_reader_line_to_gray(const bmp_band_reader_t *reader, const uint8_t *line, uint16_t x, uint16_t width,
+                                  uint8_t *gray);
+
+void bmp_band_reader_free(bmp_band_reader_t *reader);
+
 #endif
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <stdbool.h>
 #include <esp_log.h>
@@ -14,8 +15,12 @@
 #include "common_utils.h"
 #include "epd_lcd_ssd1680.h"
 #include "epdpaint.h"
+#include "epd_frame_diff.h"
+#include "epd_refresh_scheduler.h"
+#include "gui_trace.h"
 #include "key.h"
 #include "LIS3DH.h"
+#include "sht40.h"
 #include "display.h"
 #include "page_manager.h"
 #include "box_common.h"
@@ -44,9 +49,66 @@ static bool updating = false;
 static bool rotation_change = false;
 static uint8_t curr_disp_rotation;
 static bool request_update = false;
+// bit (1 << epd_update_request_t) of requests since last draw
+static uint32_t pending_update_requests = 0;
 
 static void register_event_callbacks();
 
+#if CONFIG_EPD_FRAME_DIFF_ENABLED
+#define FRAME_DIFF_MAX_BANDS 4
+// same as panel ram, updated with every upload
+static uint8_t *shadow_image = NULL;
+#endif
+
+#if CONFIG_EPD_DOUBLE_BUFFER_ENABLED
+// gui task notification index given by busy done isr and by update requests, waited while panel is busy.
+// 0 is update request count, EPD_PANEL_BUSY_NOTIFY_INDEX is busy wait of panel driver
+#define GUI_NOTIFY_INDEX_PIPELINE 2
+// recheck busy level in case busy edge is lost, same as busy wait of panel driver
+#define PIPELINE_BUSY_GUARD_MS 500
+// last drawn frame, may be still sending by dma. epd_paint draws to the other one
+static uint8_t *front_image = NULL;
+#endif
+
+#if CONFIG_EPD_DOUBLE_BUFFER_ENABLED
+static void IRAM_ATTR busy_done_isr(void *arg) {
+    gui_trace_busy_done_isr(arg);
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    vTaskGenericNotifyGiveFromISR(x_update_notify_handl, GUI_NOTIFY_INDEX_PIPELINE, &higher_priority_task_woken);
+    if (higher_priority_task_woken) {
+        portYIELD_FROM_ISR();
+    }
+}
+#endif
+
+/**
+ * add pending requests to frame_requests and merge them to one,
+ * clean wins, no flash only if every request is no flash
+ */
+static epd_update_request_t take_update_request(uint32_t *frame_requests) {
+    *frame_requests |= __atomic_exchange_n(&pending_update_requests, 0, __ATOMIC_RELAXED);
+    uint32_t requests = *frame_requests;
+    if (requests & (1 << EPD_UPDATE_CLEAN)) {
+        return EPD_UPDATE_CLEAN;
+    }
+    if (requests == (1 << EPD_UPDATE_NO_FLASH)) {
+        return EPD_UPDATE_NO_FLASH;
+    }
+    return EPD_UPDATE_NORMAL;
+}
+
+/**
+ * pass ambient temperature to panel for waveform band, sht40 keeps last result for a while
+ */
+static void update_panel_temperature() {
+    float temperature, humility;
+    if (sht40_get_temp_hum(&temperature, &humility) == ESP_OK) {
+        epd_panel_set_temperature((int8_t) temperature);
+    } else {
+        epd_panel_set_temperature(EPD_TEMPERATURE_UNKNOWN);
+    }
+}
+
 uint8_t calc_disp_rotation(uint8_t default_rotate) {
     lis3dh_direction_t disp_direction = lis3dh_get_direction();
     switch (disp_direction) {
@@ -97,6 +159,76 @@ bool spi_driver_init(int host,
     return ESP_OK != ret;
 }
 
+/**
+ * upload changed part of frame to panel ram
+ * return false if nothing changed
+ */
+static bool upload_changed_area(epd_paint_t *epd_paint, epd_area_t *refresh_area) {
+    int x, y, end_x, end_y;
+    if (!epd_paint_get_dirty_area(epd_paint, &x, &y, &end_x, &end_y)) {
+        return false;
+    }
+
+#if CONFIG_EPD_FRAME_DIFF_ENABLED
+    if (shadow_image != NULL) {
+        // rows out of dirty area not drawn, they are same as shadow
+        epd_area_t bands[FRAME_DIFF_MAX_BANDS];
+        uint8_t band_count = epd_frame_diff(shadow_image, epd_paint->image, LCD_H_RES / 8, y, end_y,
+                                            bands, FRAME_DIFF_MAX_BANDS);
+        if (band_count == 0) {
+            return false;
+        }
+
+        *refresh_area = bands[0];
+        for (uint8_t i = 0; i < band_count; i++) {
+            epd_panel_draw_frame_area(bands[i].x, bands[i].y, bands[i].end_x, bands[i].end_y, epd_paint->image);
+            epd_frame_copy_area(shadow_image, epd_paint->image, LCD_H_RES / 8, &bands[i]);
+
+            refresh_area->x = min(refresh_area->x, bands[i].x);
+            refresh_area->y = min(refresh_area->y, bands[i].y);
+            refresh_area->end_x = max(refresh_area->end_x, bands[i].end_x);
+            refresh_area->end_y = max(refresh_area->end_y, bands[i].end_y);
+        }
+        return true;
+    }
+#endif
+
+    epd_panel_draw_frame_area(x, y, end_x, end_y, epd_paint->image);
+    refresh_area->x = x;
+    refresh_area->y = y;
+    refresh_area->end_x = end_x;
+    refresh_area->end_y = end_y;
+    return true;
+}
+
+/**
+ * make epd_paint image ready to draw, it must hold last frame because menus draw over it
+ */
+static void prepare_draw_buffer(epd_paint_t *epd_paint) {
+#if CONFIG_EPD_DOUBLE_BUFFER_ENABLED
+    if (front_image != NULL) {
+        // dma only read front, no need to wait
+        memcpy(epd_paint->image, front_image, LCD_H_RES * LCD_V_RES / 8);
+        return;
+    }
+#endif
+    // frame buffer may be still sending by dma
+    epd_panel_wait_transfer_done();
+}
+
+/**
+ * drawn frame become front after upload, draw next one to the other buffer
+ */
+static void swap_draw_buffer(epd_paint_t *epd_paint) {
+#if CONFIG_EPD_DOUBLE_BUFFER_ENABLED
+    if (front_image != NULL) {
+        uint8_t *tmp = front_image;
+        front_image = epd_paint->image;
+        epd_paint->image = tmp;
+    }
+#endif
+}
+
 void draw_page(epd_paint_t *epd_paint, uint32_t loop_cnt) {
     page_inst_t current_page = page_manager_get_current_page();
     current_page.on_draw_page(epd_paint, loop_cnt);
@@ -154,21 +286,46 @@ static void guiTask(void *pvParameter) {
         return;
     }
 
+#if CONFIG_EPD_FRAME_DIFF_ENABLED
+    // first loop is full refresh, shadow is filled there
+    shadow_image = heap_caps_malloc(LCD_H_RES * LCD_V_RES * sizeof(uint8_t) / 8, MALLOC_CAP_32BIT);
+    if (!shadow_image) {
+        ESP_LOGW(TAG, "no memory for frame diff, upload all drawn area");
+    }
+#endif
+
+#if CONFIG_EPD_DOUBLE_BUFFER_ENABLED
+    front_image = heap_caps_malloc(LCD_H_RES * LCD_V_RES * sizeof(uint8_t) / 8, MALLOC_CAP_DMA);
+    if (!front_image) {
+        ESP_LOGW(TAG, "no memory for back buffer, draw after dma done");
+    }
+#endif
+
     uint8_t rotation = calc_disp_rotation(DEFAULT_DISP_ROTATION);
     curr_disp_rotation = rotation;
     epd_paint_init(epd_paint, image, LCD_H_RES, LCD_V_RES, rotation);
     epd_paint_clear(epd_paint, 0);
+#if CONFIG_EPD_DOUBLE_BUFFER_ENABLED
+    if (front_image) {
+        memcpy(front_image, image, LCD_H_RES * LCD_V_RES / 8);
+    }
+#endif
 
     static uint32_t loop_cnt = 1;
-    uint32_t last_full_refresh_loop_cnt = loop_cnt;
     static uint32_t current_tick, next_check_display_timeout_tick;
     static uint32_t ulNotificationCount, tick_to_wait;
+    epd_area_t refresh_area;
     bool wakeup_by_timer = (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER);
 
     //sleep wait for sensor init
     vTaskDelay(pdMS_TO_TICKS(10));
 
     register_event_callbacks();
+#if CONFIG_EPD_DOUBLE_BUFFER_ENABLED
+    epd_panel_register_busy_done_cb(busy_done_isr, NULL);
+#else
+    epd_panel_register_busy_done_cb(gui_trace_busy_done_isr, NULL);
+#endif
 
     while (1) {
         tick_to_wait = pdMS_TO_TICKS(5000);
@@ -188,16 +345,24 @@ static void guiTask(void *pvParameter) {
 
         bool will_enter_deep_sleep = display_timeout || wakeup_by_timer;
         if (ulNotificationCount > 0 || tick_to_wait == 0 || display_timeout) {
-            ESP_LOGI(TAG, "draw loop: %ld, boot_cnt: %ld  ulNotification: %ld lst_full_loop:%ld", loop_cnt, boot_cnt,
-                     ulNotificationCount, last_full_refresh_loop_cnt);
-
-            // use partial update mode
-            // less continue 60 times partial refresh mode or last full update time less 30min and not first loop
-            // if will enter deep sleep mode use full update
+            // bits of all requests drawn by this frame
+            uint32_t frame_requests = 0;
+            epd_update_request_t update_request = take_update_request(&frame_requests);
+            gui_trace_frame_begin(boot_cnt, loop_cnt, update_request);
+            ESP_LOGI(TAG, "draw loop: %ld, boot_cnt: %ld  ulNotification: %ld request:%d ghost:%d", loop_cnt, boot_cnt,
+                     ulNotificationCount, update_request, epd_refresh_scheduler_max_count());
+
+            // panel ram is lost after reset, first loop must be full refresh.
+            // if will enter deep sleep mode use full update, leave a clean screen
+            // else full update only when ghosting of partial refresh over budget
             bool use_full_update_mode = loop_cnt == 1
-                                        || loop_cnt - last_full_refresh_loop_cnt >= 60
-                                        || will_enter_deep_sleep;
+                                        || will_enter_deep_sleep
+                                        || epd_refresh_scheduler_need_full(update_request);
 
+            // temperature changes slowly, only check it with full refresh
+            if (use_full_update_mode) {
+                update_panel_temperature();
+            }
             epd_panel_init(use_full_update_mode ? EPD_REFRESH_MODE_FULL : EPD_REFRESH_MODE_PARTIAL);
 
             if (rotation_change) {
@@ -213,16 +378,78 @@ static void guiTask(void *pvParameter) {
             }
 
             request_update = false;
+            bool need_refresh = false;
+            gui_trace_stage(GUI_TRACE_DRAW_START);
+            prepare_draw_buffer(epd_paint);
             draw_page(epd_paint, loop_cnt);
 
-            epd_panel_draw_bitmap(0, 0, LCD_H_RES, LCD_V_RES, epd_paint->image);
-            epd_panel_refresh(use_full_update_mode, false);
-            updating = false;
+#if CONFIG_EPD_DOUBLE_BUFFER_ENABLED
+            // panel still running last waveform, upload must wait anyway.
+            // draw again for requests come in meanwhile, so the newest frame is uploaded.
+            // blocks till busy done isr or a request gives pipeline index, busy is checked only then.
+            // count left by busy done of an earlier wait is dropped before busy is read
+            ulTaskGenericNotifyTake(GUI_NOTIFY_INDEX_PIPELINE, pdTRUE, 0);
+            while (front_image && !use_full_update_mode && epd_panel_is_busy()) {
+                if (ulTaskGenericNotifyTake(0, pdTRUE, 0) > 0) {
+                    // request is drawn by this frame, nothing is left for a later one
+                    update_request = take_update_request(&frame_requests);
+                    ESP_LOGI(TAG, "redraw for request while panel busy %ld request:%d", loop_cnt, update_request);
+                    if (rotation_change) {
+                        epd_paint_set_rotation(epd_paint, curr_disp_rotation);
+                        rotation_change = false;
+                    }
+                    request_update = false;
+                    prepare_draw_buffer(epd_paint);
+                    draw_page(epd_paint, loop_cnt);
+                    gui_trace_set_flags(GUI_TRACE_FLAG_REDRAW);
+                    if (epd_refresh_scheduler_need_full(update_request)) {
+                        // clean request or over ghost budget now, upload for full refresh when busy ends
+                        use_full_update_mode = true;
+                        update_panel_temperature();
+                        epd_panel_init(EPD_REFRESH_MODE_FULL);
+                    }
+                    continue;
+                }
+                ulTaskGenericNotifyTake(GUI_NOTIFY_INDEX_PIPELINE, pdTRUE, pdMS_TO_TICKS(PIPELINE_BUSY_GUARD_MS));
+            }
+#endif
+            gui_trace_stage(GUI_TRACE_DRAW_DONE);
+
+            if (use_full_update_mode) {
+                // panel ram is lost after reset, always upload whole frame for full refresh
+                epd_panel_draw_bitmap(0, 0, LCD_H_RES, LCD_V_RES, epd_paint->image);
+#if CONFIG_EPD_FRAME_DIFF_ENABLED
+                if (shadow_image) {
+                    memcpy(shadow_image, epd_paint->image, LCD_H_RES * LCD_V_RES / 8);
+                }
+#endif
+            } else if (upload_changed_area(epd_paint, &refresh_area)) {
+                need_refresh = true;
+            } else {
+                ESP_LOGI(TAG, "frame not changed skip refresh %ld", loop_cnt);
+                gui_trace_set_flags(GUI_TRACE_FLAG_SKIPPED);
+            }
+            epd_paint_reset_dirty(epd_paint);
+            swap_draw_buffer(epd_paint);
+            gui_trace_stage(GUI_TRACE_UPLOAD_DONE);
+
+            // ram data is sending by dma now, refresh command waits for it
             after_draw_page(loop_cnt);
+            gui_trace_stage(GUI_TRACE_AFTER_DRAW_DONE);
 
             if (use_full_update_mode) {
-                last_full_refresh_loop_cnt = loop_cnt;
+                epd_panel_refresh(true, false);
+                epd_refresh_scheduler_on_full_refresh();
+                gui_trace_set_flags(GUI_TRACE_FLAG_FULL_REFRESH);
+                gui_trace_stage(GUI_TRACE_REFRESH_START);
+            } else if (need_refresh) {
+                // only refresh area changed by draw page
+                epd_panel_refresh_area(refresh_area.x, refresh_area.y, refresh_area.end_x, refresh_area.end_y, false);
+                epd_refresh_scheduler_on_partial_refresh(refresh_area.x, refresh_area.y,
+                                                         refresh_area.end_x, refresh_area.end_y);
+                gui_trace_stage(GUI_TRACE_REFRESH_START);
             }
+            updating = false;
 
             ESP_LOGI(TAG, "draw page done %ld", loop_cnt);
             loop_cnt += 1;
@@ -242,8 +469,12 @@ static void guiTask(void *pvParameter) {
     }
 
     epd_panel_sleep();
+    // free drawing buffer, it may be any of the two
     epd_paint_deinit(epd_paint);
-    free(image);
+#if CONFIG_EPD_DOUBLE_BUFFER_ENABLED
+    free(front_image);
+    front_image = NULL;
+#endif
     free(epd_paint);
 
     vTaskDelete(NULL);
@@ -253,11 +484,17 @@ void request_display_update_handler(void *event_handler_arg, esp_event_base_t ev
                                     void *event_data) {
     if (BIKE_REQUEST_UPDATE_DISPLAY_EVENT == event_base) {
         uint32_t before_value;
-        int full_update = (int) event_data;
+        uint32_t update_request = event_data != NULL ? *(uint32_t *) event_data : EPD_UPDATE_NORMAL;
+        __atomic_fetch_or(&pending_update_requests, 1 << update_request, __ATOMIC_RELAXED);
         request_update = true;
+        gui_trace_notify();
 
-        xTaskGenericNotify(x_update_notify_handl, 0, full_update,
+        xTaskGenericNotify(x_update_notify_handl, 0, 0,
                            eIncrement, &before_value);
+#if CONFIG_EPD_DOUBLE_BUFFER_ENABLED
+        // wake gui if it waits panel busy to redraw
+        xTaskGenericNotify(x_update_notify_handl, GUI_NOTIFY_INDEX_PIPELINE, 0, eIncrement, NULL);
+#endif
         ESP_LOGI(TAG, "request for update... %ld", before_value);
     }
 }
@@ -273,7 +510,7 @@ static void acc_motion_event_handler(void *event_handler_arg, esp_event_base_t e
             lis3dh_direction_t *d = (lis3dh_direction_t *) event_data;
             curr_disp_rotation = calc_disp_rotation(curr_disp_rotation);
             ESP_LOGI(TAG, "request update for rotation change %d %d", *d, curr_disp_rotation);
-            page_manager_request_update(false);
+            page_manager_request_update(EPD_UPDATE_NORMAL);
             break;
         default:
             lst_event_tick = xTaskGetTickCount();
@@ -282,6 +519,9 @@ static void acc_motion_event_handler(void *event_handler_arg, esp_event_base_t e
 
 static void update_lst_event_tick_handler(void *event_handler_arg, esp_event_base_t event_base, int32_t event_id, void *event_data) {
     lst_event_tick = xTaskGetTickCount();
+    if (event_base == BIKE_KEY_EVENT) {
+        gui_trace_key_event();
+    }
 }
 
 static void register_event_callbacks() {
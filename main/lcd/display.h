@@ -2,6 +2,7 @@
 #define DISPLAY_H
 
 #include "key.h"
+#include "epd_refresh_scheduler.h"
 
 #define DEEP_SLEEP_TIMEOUT_MS 90000
 
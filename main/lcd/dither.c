@@ -0,0 +1,132 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "dither.h"
+
+static const uint8_t bayer_4[4][4] = {
+        {0,  8,  2,  10},
+        {12, 4,  14, 6},
+        {3,  11, 1,  9},
+        {15, 7,  13, 5},
+};
+
+static const uint8_t bayer_8[8][8] = {
+        {0,  32, 8,  40, 2,  34, 10, 42},
+        {48, 16, 56, 24, 50, 18, 58, 26},
+        {12, 44, 4,  36, 14, 46, 6,  38},
+        {60, 28, 52, 20, 62, 30, 54, 22},
+        {3,  35, 11, 43, 1,  33, 9,  41},
+        {51, 19, 59, 27, 49, 17, 57, 25},
+        {15, 47, 7,  39, 13, 45, 5,  37},
+        {63, 31, 55, 23, 61, 29, 53, 21},
+};
+
+static const char *const mode_names[DITHER_MODE_COUNT] = {"fs", "atkinson", "bayer4", "bayer8", "threshold"};
+
+bool dither_init(dither_t *dither, dither_mode_t mode, uint16_t width) {
+    dither->mode = mode;
+    dither->width = width;
+    dither->row = 0;
+    dither->err_cur = NULL;
+    dither->err_next = NULL;
+    if (mode != DITHER_FLOYD_STEINBERG && mode != DITHER_ATKINSON) {
+        return true;
+    }
+
+    int16_t *err_rows = calloc(2 * (width + 2), sizeof(int16_t));
+    if (err_rows == NULL) {
+        return false;
+    }
+    dither->err_cur = err_rows;
+    dither->err_next = err_rows + width + 2;
+    return true;
+}
+
+/**
+ * err_cur[i + 1] is error of pixel i, forward error of this row is kept in locals,
+ * so err_cur of a pixel is free after read and takes error of row after next (atkinson) or 0.
+ */
+static void diffuse_row(dither_t *dither, uint8_t *gray) {
+    int16_t *cur = dither->err_cur + 1;
+    int16_t *next = dither->err_next + 1;
+    int width = dither->width;
+    int dir = (dither->row & 1) ? -1 : 1;
+    int i = dir > 0 ? 0 : width - 1;
+    int end = dir > 0 ? width : -1;
+    int carry = 0, carry2 = 0;
+
+    if (dither->mode == DITHER_FLOYD_STEINBERG) {
+        for (; i != end; i += dir) {
+            int v = gray[i] + cur[i] + carry;
+            int err = v > 127 ? v - 255 : v;
+            gray[i] = v > 127 ? 255 : 0;
+            cur[i] = 0;
+            carry = err * 7 / 16;
+            next[i - dir] += err * 3 / 16;
+            next[i] += err * 5 / 16;
+            next[i + dir] += err / 16;
+        }
+    } else {
+        for (; i != end; i += dir) {
+            int v = gray[i] + cur[i] + carry;
+            int err = v > 127 ? v - 255 : v;
+            gray[i] = v > 127 ? 255 : 0;
+            err /= 8;
+            carry = carry2 + err;
+            carry2 = err;
+            cur[i] = err;
+            next[i - dir] += err;
+            next[i] += err;
+            next[i + dir] += err;
+        }
+        // second pixel beyond the row end is dropped, like the guard column
+    }
+
+    // guards got error of pixels out of row
+    dither->err_cur[0] = dither->err_cur[width + 1] = 0;
+    dither->err_next[0] = dither->err_next[width + 1] = 0;
+    // cur now holds row after next
+    int16_t *t = dither->err_cur;
+    dither->err_cur = dither->err_next;
+    dither->err_next = t;
+}
+
+void dither_row(dither_t *dither, uint8_t *gray, int x, int y) {
+    switch (dither->mode) {
+        case DITHER_FLOYD_STEINBERG:
+        case DITHER_ATKINSON:
+            diffuse_row(dither, gray);
+            break;
+        case DITHER_BAYER_4: {
+            const uint8_t *m = bayer_4[y & 3];
+            for (int i = 0; i < dither->width; i++) {
+                gray[i] = gray[i] > m[(x + i) & 3] * 16 + 8 ? 255 : 0;
+            }
+            break;
+        }
+        case DITHER_BAYER_8: {
+            const uint8_t *m = bayer_8[y & 7];
+            for (int i = 0; i < dither->width; i++) {
+                gray[i] = gray[i] > m[(x + i) & 7] * 4 + 2 ? 255 : 0;
+            }
+            break;
+        }
+        default:
+            for (int i = 0; i < dither->width; i++) {
+                gray[i] = gray[i] >= 128 ? 255 : 0;
+            }
+            break;
+    }
+    dither->row++;
+}
+
+void dither_deinit(dither_t *dither) {
+    // both rows are one block, start of it is the lower pointer
+    free(dither->err_cur < dither->err_next ? dither->err_cur : dither->err_next);
+    dither->err_cur = NULL;
+    dither->err_next = NULL;
+}
+
+const char *dither_mode_name(dither_mode_t mode) {
+    return mode < DITHER_MODE_COUNT ? mode_names[mode] : "unknown";
+}
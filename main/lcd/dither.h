@@ -0,0 +1,44 @@
+#ifndef DITHER_H
+#define DITHER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * gray to black and white by rows, integer only.
+ * error diffusion keeps two error rows, ordered and threshold need no buffer.
+ */
+
+typedef enum {
+    DITHER_FLOYD_STEINBERG = 0, // serpentine
+    DITHER_ATKINSON, // serpentine, 6/8 of error spread, more contrast for small screen
+    DITHER_BAYER_4,
+    DITHER_BAYER_8,
+    DITHER_THRESHOLD,
+    DITHER_MODE_COUNT,
+} dither_mode_t;
+
+typedef struct {
+    dither_mode_t mode;
+    uint16_t width;
+    uint16_t row; // rows done, odd rows go right to left
+    int16_t *err_cur; // width + 2, one guard each side
+    int16_t *err_next;
+} dither_t;
+
+/**
+ * return false if no memory for error rows
+ */
+bool dither_init(dither_t *dither, dither_mode_t mode, uint16_t width);
+
+/**
+ * gray in, 0 / 255 out in place. rows must come top down.
+ * x y are screen position of first pixel, ordered pattern is fixed to screen.
+ */
+void dither_row(dither_t *dither, uint8_t *gray, int x, int y);
+
+void dither_deinit(dither_t *dither);
+
+const char *dither_mode_name(dither_mode_t mode);
+
+#endif
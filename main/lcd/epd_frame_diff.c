@@ -0,0 +1,71 @@
+#include <string.h>
+
+#include "epd_frame_diff.h"
+
+// changed rows closer than this are uploaded in one band, a band costs some commands to set ram window
+#define BAND_MERGE_GAP_ROWS 4
+
+static void add_changed_byte(epd_area_t *bands, uint8_t *band_count, uint8_t max_bands, int row, int col) {
+    epd_area_t *band = *band_count > 0 ? &bands[*band_count - 1] : NULL;
+    // rows come in ascending order
+    if (band == NULL || (row - band->end_y >= BAND_MERGE_GAP_ROWS && *band_count < max_bands)) {
+        band = &bands[(*band_count)++];
+        band->x = col * 8;
+        band->end_x = col * 8 + 8;
+        band->y = row;
+        band->end_y = row + 1;
+        return;
+    }
+
+    if (col * 8 < band->x) band->x = col * 8;
+    if (col * 8 + 8 > band->end_x) band->end_x = col * 8 + 8;
+    band->end_y = row + 1;
+}
+
+uint8_t epd_frame_diff(const uint8_t *old_frame, const uint8_t *new_frame, int stride, int start_y, int end_y,
+                       epd_area_t *bands, uint8_t max_bands) {
+    uint8_t band_count = 0;
+    if (start_y >= end_y || max_bands == 0) {
+        return 0;
+    }
+
+    // compare by word, rows are not word aligned so word range covers a little more
+    int start = start_y * stride;
+    int end = end_y * stride;
+    int word_start = start / 4;
+    int word_end = end / 4;
+    const uint32_t *old_words = (const uint32_t *) old_frame;
+    const uint32_t *new_words = (const uint32_t *) new_frame;
+
+    for (int i = word_start; i < word_end; i++) {
+        if (old_words[i] == new_words[i]) {
+            continue;
+        }
+        for (int k = i * 4; k < i * 4 + 4; k++) {
+            if (k >= start && old_frame[k] != new_frame[k]) {
+                add_changed_byte(bands, &band_count, max_bands, k / stride, k % stride);
+            }
+        }
+    }
+
+    // tail bytes not fill a word
+    for (int k = word_end * 4 > start ? word_end * 4 : start; k < end; k++) {
+        if (old_frame[k] != new_frame[k]) {
+            add_changed_byte(bands, &band_count, max_bands, k / stride, k % stride);
+        }
+    }
+
+    return band_count;
+}
+
+void epd_frame_copy_area(uint8_t *old_frame, const uint8_t *new_frame, int stride, const epd_area_t *area) {
+    int offset = area->x / 8;
+    int len = (area->end_x - area->x) / 8;
+    if (len == stride) {
+        memcpy(old_frame + area->y * stride, new_frame + area->y * stride, len * (area->end_y - area->y));
+        return;
+    }
+    for (int y = area->y; y < area->end_y; y++) {
+        memcpy(old_frame + y * stride + offset, new_frame + y * stride + offset, len);
+    }
+}
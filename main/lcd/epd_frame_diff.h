@@ -0,0 +1,28 @@
+#ifndef EPD_FRAME_DIFF_H
+#define EPD_FRAME_DIFF_H
+
+#include <stdint.h>
+
+// area of frame buffer, x y include, end_x end_y not include
+typedef struct {
+    int16_t x;
+    int16_t y;
+    int16_t end_x;
+    int16_t end_y;
+} epd_area_t;
+
+/**
+ * compare rows [start_y, end_y) of two 1bpp frames and group changed rows into bands,
+ * every band has its own byte aligned column range.
+ * frames must be 4 bytes aligned, stride is bytes per row.
+ * return band count, 0 if nothing changed
+ */
+uint8_t epd_frame_diff(const uint8_t *old_frame, const uint8_t *new_frame, int stride, int start_y, int end_y,
+                       epd_area_t *bands, uint8_t max_bands);
+
+/**
+ * copy area of new frame to old frame, x and end_x must be aligned to byte
+ */
+void epd_frame_copy_area(uint8_t *old_frame, const uint8_t *new_frame, int stride, const epd_area_t *area);
+
+#endif
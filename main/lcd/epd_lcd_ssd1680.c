@@ -5,12 +5,12 @@
 #include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "freertos/semphr.h"
 #include "driver/gpio.h"
 #include "driver/spi_master.h"
 #include "esp_log.h"
 #include "esp_check.h"
 #include "esp_timer.h"
+#include "esp_heap_caps.h"
 
 #include "lcd/epdpaint.h"
 #include "epd_lcd_ssd1680.h"
@@ -19,6 +19,19 @@ static const char *TAG = "epd_panel";
 
 #define TRANSFER_QUEUE_SIZE 10
 
+// max bytes of one queued ram data transaction, full frame is sent in a few transactions
+#define QUEUED_TRANS_MAX_SIZE 4096
+
+// waveform lut bytes sent by WRITE_LUT_REGISTER, rest of table are voltage registers
+#define WF_LUT_SIZE 153
+// 12 groups of [TPA, TPB, SRAB, TPC, TPD, SRCD, RP] after 5 x 12 bytes of VS
+#define WF_LUT_GROUP_OFFSET 60
+#define WF_LUT_GROUP_COUNT 12
+#define WF_LUT_GROUP_SIZE 7
+
+// wait busy is woken by busy falling edge, this timeout only recheck level in case edge lost
+#define BUSY_WAIT_GUARD_MS 500
+
 unsigned char WF_Full_1IN54[159] =
         {
                 0x80, 0x48, 0x40, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
@@ -89,27 +102,74 @@ unsigned char WF_PARTIAL_1IN54[159] =
 #define SSD1680_CMD_SET_RAM_Y_START_END             0x45
 #define SSD1680_CMD_SET_RAM_X_ADDRESS_COUNTER       0x4E
 #define SSD1680_CMD_SET_RAM_Y_ADDRESS_COUNTER       0x4F
+#define SSD1680_CMD_AUTO_WRITE_RED_RAM              0x46
+#define SSD1680_CMD_AUTO_WRITE_BW_RAM               0x47
 
-static SemaphoreHandle_t busySemaphore;
+/**
+ * stock tables are tuned at room temperature. cold panel needs longer phases to drive
+ * particles fully, warm panel is fine with shorter ones.
+ * phase frame counts of stock table are scaled by percent for each band.
+ */
+typedef struct {
+    int8_t min_temperature;
+    uint8_t full_percent;
+    uint8_t partial_percent;
+} wf_temperature_band_t;
+
+static const wf_temperature_band_t wf_temperature_bands[] = {
+        {INT8_MIN, 150, 160},
+        {5,        125, 130},
+        {15,       100, 100},
+        {30,       90,  80},
+};
+
+#define WF_TEMPERATURE_BAND_COUNT (sizeof(wf_temperature_bands) / sizeof(wf_temperature_bands[0]))
+#define WF_STOCK_BAND 2
+
+// scaled tables built on first use, [0] full, [1] partial
+static uint8_t *wf_band_luts[2][WF_TEMPERATURE_BAND_COUNT];
+
+// busy line falling edge notify this task, NULL if nobody waiting
+static volatile TaskHandle_t busy_wait_task = NULL;
+static epd_panel_busy_done_cb_t busy_done_cb = NULL;
+static void *busy_done_cb_arg = NULL;
 static int64_t start_wait_time, end_wait_time;
 static lcd_ssd1680_panel_t panel;
 
-void lcd_spi_pre_transfer_callback(spi_transaction_t *t) {
+// ram data transactions queued to spi dma, results come back in queue order
+static spi_transaction_t queued_trans[TRANSFER_QUEUE_SIZE];
+static uint8_t queued_trans_head = 0;
+static uint8_t queued_trans_count = 0;
+
+// dma buffer to pack rows of a ram window
+static uint8_t *staging_buff = NULL;
+static size_t staging_buff_size = 0;
+
+// queued transactions run these in spi isr, which stays on while flash cache is off for spiffs / nvs writes.
+// gpio_set_level is in iram by CONFIG_GPIO_CTRL_FUNC_IN_IRAM
+void IRAM_ATTR lcd_spi_pre_transfer_callback(spi_transaction_t *t) {
     if (DISP_DC_GPIO_NUM > 0) {
         int dc = (int) t->user;
         gpio_set_level(DISP_DC_GPIO_NUM, dc);
     }
 }
 
-static void lcd_spi_post_trans_callback(spi_transaction_t *trans) {
+static void IRAM_ATTR lcd_spi_post_trans_callback(spi_transaction_t *trans) {
 }
 
 static void IRAM_ATTR busy_gpio_isr_handler(void *arg) {
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    /* Notify the task that the transmission is complete. */
-    //vTaskNotifyGiveIndexedFromISR(xTaskToNotify, 0, &xHigherPriorityTaskWoken);
-    xSemaphoreGiveFromISR(busySemaphore, &xHigherPriorityTaskWoken);
-    //portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    /* Notify the task waiting busy low */
+    TaskHandle_t task = busy_wait_task;
+    if (task != NULL) {
+        vTaskGenericNotifyGiveFromISR(task, EPD_PANEL_BUSY_NOTIFY_INDEX, &xHigherPriorityTaskWoken);
+    }
+    if (busy_done_cb != NULL) {
+        busy_done_cb(busy_done_cb_arg);
+    }
+    if (xHigherPriorityTaskWoken) {
+        portYIELD_FROM_ISR();
+    }
 }
 
 esp_err_t epd_panel_driver_init(spi_host_device_t bus) {
@@ -118,6 +178,7 @@ esp_err_t epd_panel_driver_init(spi_host_device_t bus) {
     panel.dc_gpio_num = DISP_DC_GPIO_NUM;
     panel.reset_level = 0;
     panel.refresh_mode = EPD_REFRESH_MODE_UNSET;
+    panel.temperature = EPD_TEMPERATURE_UNKNOWN;
 
     esp_err_t ret = ESP_OK;
     if (panel.reset_gpio_num >= 0) {
@@ -130,9 +191,6 @@ esp_err_t epd_panel_driver_init(spi_host_device_t bus) {
 
     // set up busy gpio
     if (panel.busy_gpio_num >= 0) {
-        // first create take is block should give first
-        busySemaphore = xSemaphoreCreateBinary();
-
         // setup gpio
         ESP_LOGI(TAG, "busy pin is %d", panel.busy_gpio_num);
         gpio_config_t busy_io_config = {
@@ -180,9 +238,57 @@ esp_err_t epd_panel_driver_init(spi_host_device_t bus) {
     return ret;
 }
 
+/**
+ * take back queued transactions until no more than keep_count in flight
+ */
+static esp_err_t wait_queued_trans(uint8_t keep_count, TickType_t ticks_to_wait) {
+    spi_transaction_t *rtrans;
+    while (queued_trans_count > keep_count) {
+        esp_err_t ret = spi_device_get_trans_result(panel.spi_dev, &rtrans, ticks_to_wait);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        queued_trans_count--;
+    }
+    return ESP_OK;
+}
+
+/**
+ * queue ram data to spi dma and return without waiting,
+ * data must not be changed before epd_panel_wait_transfer_done.
+ */
+static esp_err_t lcd_data_queued(const uint8_t *data, size_t len) {
+    esp_err_t ret = ESP_OK;
+    while (len > 0) {
+        size_t trans_len = len > QUEUED_TRANS_MAX_SIZE ? QUEUED_TRANS_MAX_SIZE : len;
+
+        // reuse the oldest transaction if all are in flight
+        ret = wait_queued_trans(TRANSFER_QUEUE_SIZE - 1, portMAX_DELAY);
+        ESP_GOTO_ON_ERROR(ret, err, TAG, "spi get queued trans result failed");
+
+        spi_transaction_t *t = &queued_trans[queued_trans_head];
+        memset(t, 0, sizeof(spi_transaction_t));
+        t->length = trans_len * 8;
+        t->tx_buffer = data;
+        t->user = (void *) 1; //D/C needs to be set to 1
+        ret = spi_device_queue_trans(panel.spi_dev, t, portMAX_DELAY);
+        ESP_GOTO_ON_ERROR(ret, err, TAG, "spi queue data failed");
+
+        queued_trans_head = (queued_trans_head + 1) % TRANSFER_QUEUE_SIZE;
+        queued_trans_count++;
+        data += trans_len;
+        len -= trans_len;
+    }
+
+    err:
+    return ret;
+}
+
 static esp_err_t lcd_data(const uint8_t *data, size_t len) {
     // ESP_LOGI(TAG, "lcd data 0x%02x len:%d", *data, len);
     esp_err_t ret;
+    // polling transmit can not run with queued transactions in flight
+    wait_queued_trans(0, portMAX_DELAY);
     spi_transaction_t t;
     memset(&t, 0, sizeof(t));       //Zero out the transaction
     t.length = len * 8;             //Len is in bytes, transaction length is in bits.
@@ -198,6 +304,8 @@ static esp_err_t lcd_data(const uint8_t *data, size_t len) {
 static esp_err_t lcd_cmd(const uint8_t cmd, const void *param, size_t param_size) {
     // ESP_LOGI(TAG, "lcd cmd 0x%02x", cmd);
     esp_err_t ret;
+    // keep order with queued ram data
+    wait_queued_trans(0, portMAX_DELAY);
     spi_transaction_t t;
     memset(&t, 0, sizeof(t));       //Zero out the transaction
     t.length = 8;                     //Command is 8 bits
@@ -218,22 +326,131 @@ static esp_err_t lcd_cmd(const uint8_t cmd, const void *param, size_t param_size
 static void wait_for_busy(char *reason) {
     start_wait_time = esp_timer_get_time();
     //• Wait BUSY Low
-    while (true) {
-        if (!gpio_get_level(panel.busy_gpio_num)) {
-            break;
-        }
-        xSemaphoreTake(busySemaphore, pdMS_TO_TICKS(100));
-        //uint32_t ulNotificationValueCount = ulTaskNotifyTakeIndexed(0, pdTRUE, pdMS_TO_TICKS(500));
+    // register before read level, so a falling edge between them still wake us
+    busy_wait_task = xTaskGetCurrentTaskHandle();
+    // an edge of earlier wait may be left after level read low or guard timeout
+    ulTaskGenericNotifyTake(EPD_PANEL_BUSY_NOTIFY_INDEX, pdTRUE, 0);
+    while (gpio_get_level(panel.busy_gpio_num)) {
+        // timeout only guard a lost edge, normally woken by busy isr.
+        // own index, update requests to the task on index 0 are left for it
+        ulTaskGenericNotifyTake(EPD_PANEL_BUSY_NOTIFY_INDEX, pdTRUE, pdMS_TO_TICKS(BUSY_WAIT_GUARD_MS));
     }
+    busy_wait_task = NULL;
     end_wait_time = esp_timer_get_time();
-    ESP_LOGI(TAG, "wait %s busy done cost %lldms", reason, (end_wait_time - start_wait_time) / 1000);
+    ESP_LOGD(TAG, "wait %s busy done cost %lldms", reason, (end_wait_time - start_wait_time) / 1000);
 }
 
-static void set_lut_by_host(uint8_t *lut, uint8_t len) {
+bool epd_panel_is_busy() {
+    return gpio_get_level(panel.busy_gpio_num) != 0;
+}
+
+void epd_panel_register_busy_done_cb(epd_panel_busy_done_cb_t cb, void *arg) {
+    gpio_intr_disable(panel.busy_gpio_num);
+    busy_done_cb = cb;
+    busy_done_cb_arg = arg;
+    gpio_intr_enable(panel.busy_gpio_num);
+}
+
+static void set_lut_by_host(const uint8_t *lut, uint8_t len) {
+    if (panel._current_lut == lut) {
+        return;
+    }
     lcd_cmd(SSD1680_CMD_WRITE_LUT_REGISTER, lut, len);
+    panel._current_lut = lut;
     //wait_for_busy("lut");
 }
 
+static uint8_t get_temperature_band(int8_t temperature) {
+    if (temperature == EPD_TEMPERATURE_UNKNOWN) {
+        return WF_STOCK_BAND;
+    }
+    uint8_t band = 0;
+    for (uint8_t i = 1; i < WF_TEMPERATURE_BAND_COUNT; i++) {
+        if (temperature >= wf_temperature_bands[i].min_temperature) {
+            band = i;
+        }
+    }
+    return band;
+}
+
+/**
+ * waveform table of mode for temperature band, fall back to stock table if no memory
+ */
+static const uint8_t *get_band_waveform(epd_refresh_mode_t mode, uint8_t band) {
+    const uint8_t *stock = mode == EPD_REFRESH_MODE_FULL ? WF_Full_1IN54 : WF_PARTIAL_1IN54;
+    if (band == WF_STOCK_BAND) {
+        return stock;
+    }
+
+    uint8_t **cached = &wf_band_luts[mode == EPD_REFRESH_MODE_FULL ? 0 : 1][band];
+    if (*cached != NULL) {
+        return *cached;
+    }
+
+    uint8_t *lut = malloc(sizeof(WF_Full_1IN54));
+    if (lut == NULL) {
+        ESP_LOGW(TAG, "no memory for waveform of band %d, use stock", band);
+        return stock;
+    }
+
+    memcpy(lut, stock, sizeof(WF_Full_1IN54));
+    uint8_t percent = mode == EPD_REFRESH_MODE_FULL ? wf_temperature_bands[band].full_percent
+                                                    : wf_temperature_bands[band].partial_percent;
+    for (int g = 0; g < WF_LUT_GROUP_COUNT; g++) {
+        uint8_t *group = lut + WF_LUT_GROUP_OFFSET + g * WF_LUT_GROUP_SIZE;
+        // TPA TPB TPC TPD, keep SR and RP
+        static const uint8_t tp_index[] = {0, 1, 3, 4};
+        for (int i = 0; i < sizeof(tp_index); i++) {
+            uint8_t *tp = &group[tp_index[i]];
+            if (*tp == 0) {
+                continue;
+            }
+            uint32_t scaled = (*tp * percent + 50) / 100;
+            *tp = scaled < 1 ? 1 : (scaled > 0xFF ? 0xFF : scaled);
+        }
+    }
+
+    *cached = lut;
+    return lut;
+}
+
+void epd_panel_set_temperature(int8_t temperature) {
+    panel.temperature = temperature;
+}
+
+/**
+ * write register only if value differs from last write since reset
+ */
+static esp_err_t lcd_cmd_cached(uint8_t cmd, const uint8_t *param, uint8_t param_size) {
+    assert(param_size <= SSD1680_REG_CACHE_DATA_SIZE);
+    ssd1680_reg_cache_t *reg = NULL;
+    for (uint8_t i = 0; i < panel._reg_cache_count; i++) {
+        if (panel._reg_cache[i].cmd == cmd) {
+            reg = &panel._reg_cache[i];
+            break;
+        }
+    }
+
+    if (reg != NULL && reg->len == param_size && memcmp(reg->data, param, param_size) == 0) {
+        return ESP_OK;
+    }
+
+    esp_err_t ret = lcd_cmd(cmd, param, param_size);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    if (reg == NULL && panel._reg_cache_count < SSD1680_REG_CACHE_SIZE) {
+        reg = &panel._reg_cache[panel._reg_cache_count++];
+    }
+    if (reg != NULL) {
+        reg->cmd = cmd;
+        reg->len = param_size;
+        memcpy(reg->data, param, param_size);
+    }
+    return ESP_OK;
+}
+
 void reset_panel_state() {
     panel._current_mem_area_start_x = -1;
     panel._current_mem_area_start_y = -1;
@@ -241,6 +458,10 @@ void reset_panel_state() {
     panel._current_mem_pointer_y = -1;
 
     panel.refresh_mode = EPD_REFRESH_MODE_UNSET;
+
+    panel._base_configured = false;
+    panel._current_lut = NULL;
+    panel._reg_cache_count = 0;
 }
 
 esp_err_t epd_panel_reset() {
@@ -321,8 +542,8 @@ static esp_err_t set_mem_pointer(uint16_t x, uint16_t y) {
  *          set the other memory area.
  */
 esp_err_t update_full(bool waitdone) {
-    // Display with DISPLAY Mode 1
-    lcd_cmd(SSD1680_CMD_DISPLAY_UPDATE_CONTROL_2, (uint8_t[]) {0xC7}, 1);
+    // Display with DISPLAY Mode 1, register kept after activation, only mode change rewrites it
+    lcd_cmd_cached(SSD1680_CMD_DISPLAY_UPDATE_CONTROL_2, (uint8_t[]) {0xC7}, 1);
     lcd_cmd(SSD1680_CMD_MASTER_ACTIVATION, NULL, 0);
     if (waitdone) {
         wait_for_busy("full refresh");
@@ -333,7 +554,7 @@ esp_err_t update_full(bool waitdone) {
 
 esp_err_t update_part(bool waitdone) {
     // Display with DISPLAY Mode 2
-    lcd_cmd(SSD1680_CMD_DISPLAY_UPDATE_CONTROL_2, (uint8_t[]) {0xCF}, 1);
+    lcd_cmd_cached(SSD1680_CMD_DISPLAY_UPDATE_CONTROL_2, (uint8_t[]) {0xCF}, 1);
     lcd_cmd(SSD1680_CMD_MASTER_ACTIVATION, NULL, 0);
     if (waitdone) {
         wait_for_busy("part refresh");
@@ -342,26 +563,99 @@ esp_err_t update_part(bool waitdone) {
     return ESP_OK;
 }
 
-esp_err_t epd_panel_clear_display(uint8_t color) {
+/**
+ * get dma buffer to pack window rows, grow if too small.
+ * staging buffer may be still sending, wait before change it
+ */
+static uint8_t *get_staging_buff(size_t len) {
+    wait_queued_trans(0, portMAX_DELAY);
+    if (staging_buff_size < len) {
+        free(staging_buff);
+        staging_buff = heap_caps_malloc(len, MALLOC_CAP_DMA);
+        staging_buff_size = staging_buff == NULL ? 0 : len;
+    }
+    return staging_buff;
+}
+
+/**
+ * write rows to ram window already set, src_stride is bytes between rows of src.
+ * rows are packed to continuous buffer so the window is sent in one or two dma transactions
+ */
+static esp_err_t write_ram_window(const uint8_t *src, int src_stride, int rows, int row_bytes) {
+    esp_err_t ret = lcd_cmd(SSD1680_CMD_WRITE_RAM, NULL, 0);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    if (row_bytes == src_stride || rows == 1) {
+        // already continuous
+        return lcd_data_queued(src, rows * row_bytes);
+    }
+
+    uint8_t *buff = get_staging_buff(rows * row_bytes);
+    if (buff == NULL) {
+        ESP_LOGW(TAG, "no memory for staging buff, send %d rows one by one", rows);
+        for (int i = 0; i < rows; i++) {
+            ret = lcd_data_queued(src + i * src_stride, row_bytes);
+            if (ret != ESP_OK) {
+                return ret;
+            }
+        }
+        return ESP_OK;
+    }
+
+    for (int i = 0; i < rows; i++) {
+        memcpy(buff + i * row_bytes, src + i * src_stride, row_bytes);
+    }
+    return lcd_data_queued(buff, rows * row_bytes);
+}
+
+/**
+ * fill whole ram with color byte.
+ * solid color use auto write, panel fills ram itself without spi data,
+ * other pattern is streamed from staging buffer
+ */
+static esp_err_t fill_ram(uint8_t write_cmd, uint8_t auto_write_cmd, uint8_t color) {
     set_mem_area(0, 0, LCD_H_RES, LCD_V_RES);
     set_mem_pointer(0, 0);
 
-    // size_t len = LCD_H_RES * LCD_V_RES / 8;
-    lcd_cmd(SSD1680_CMD_WRITE_RAM, NULL, 0);
+    if (color == 0x00 || color == 0xFF) {
+        // A7 first value, A6:4 step height 296, A2:0 step width 176, larger than ram so no pattern change
+        lcd_cmd(auto_write_cmd, (uint8_t[]) {(color & 0x80) | 0x77}, 1);
+        wait_for_busy("auto write ram");
+        return ESP_OK;
+    }
 
-    for (int j = 0; j < LCD_V_RES; j++) {
-        for (int i = 0; i < LCD_H_RES / 8; i++) {
-            lcd_data(&color, 1);
-        }
+    const size_t len = LCD_H_RES * LCD_V_RES / 8;
+    uint8_t *buff = get_staging_buff(len);
+    lcd_cmd(write_cmd, NULL, 0);
+    if (buff != NULL) {
+        memset(buff, color, len);
+        return lcd_data_queued(buff, len);
     }
 
-//    lcd_cmd( SSD1680_CMD_WRITE_RAM_RED, NULL, 0);
-//    for (int j = 0; j < LCD_V_RES; j++) {
-//        for (int i = 0; i < LCD_H_RES / 8; i++) {
-//            lcd_data(&color, 1);
-//        }
-//    }
+    // no memory for whole frame, send a line many times
+    static uint8_t line[LCD_H_RES / 8];
+    wait_queued_trans(0, portMAX_DELAY);
+    memset(line, color, sizeof(line));
+    for (int y = 0; y < LCD_V_RES; y++) {
+        lcd_data_queued(line, sizeof(line));
+    }
+    return ESP_OK;
+}
 
+esp_err_t epd_panel_clear_ram(uint8_t color, bool clear_red) {
+    wait_for_busy("before clear");
+    fill_ram(SSD1680_CMD_WRITE_RAM, SSD1680_CMD_AUTO_WRITE_BW_RAM, color);
+    if (clear_red) {
+        // red ram is the old frame of ping-pong partial refresh
+        fill_ram(SSD1680_CMD_WRITE_RAM_RED, SSD1680_CMD_AUTO_WRITE_RED_RAM, color);
+    }
+    return ESP_OK;
+}
+
+esp_err_t epd_panel_clear_display(uint8_t color) {
+    epd_panel_clear_ram(color, false);
     epd_panel_refresh(false, true);
     ESP_LOGI(TAG, "ssd1680 clear display ...");
     return ESP_OK;
@@ -380,7 +674,7 @@ epd_panel_draw_bitmap(int16_t x_start, int16_t y_start, int16_t x_end, int16_t y
 
     int wb = (w + 7) / 8; // width bytes, bitmaps are padded
 
-    x_start -= x_start % 8; // byte boundary
+    x_start &= ~7; // byte boundary, round down for negative x too
     w = wb * 8; // byte boundary
 
     int x1 = x_start < 0 ? 0 : x_start;
@@ -396,36 +690,51 @@ epd_panel_draw_bitmap(int16_t x_start, int16_t y_start, int16_t x_end, int16_t y
 
     if ((w1 <= 0) || (h1 <= 0)) return ESP_OK;
 
-    set_mem_area(x1, y1, x1 + w, y1 + h);
+    // ram window must be same as data sent, or address counter wraps at wrong place
+    set_mem_area(x1, y1, x1 + w1, y1 + h1);
     set_mem_pointer(x1, y1);
 
-    size_t len = h1 * w1 / 8;
-    if (len == LCD_H_RES * LCD_V_RES / 8) {
-        // transfer frame buffer
-        lcd_cmd(SSD1680_CMD_WRITE_RAM, color_data, len);
-    } else {
-        lcd_cmd(SSD1680_CMD_WRITE_RAM, NULL, 0);
-        for (int16_t i = 0; i < h1; i++) {
-            // method1 one byte by one byte
-//            for (int16_t j = 0; j < w1 / 8; j++) {
-//                uint8_t data;
-//                // use wb, h of bitmap for index!
-//                int16_t idx = j + dx / 8 + (i + dy) * wb;
-//                data = ((uint8_t *) color_data)[idx];
-//                lcd_data(panel, &data, 1);
-//            }
-
-            // method 2 full line (w1 / 8) byte
-            int16_t idx = dx / 8 + (i + dy) * wb;
-            uint8_t data = ((uint8_t *) color_data)[idx];
-            lcd_data(&data, w1 / 8);
-        }
-        vTaskDelay(pdMS_TO_TICKS(1));
-    }
+    write_ram_window((const uint8_t *) color_data + dx / 8 + dy * wb, wb, h1, w1 / 8);
+    return ESP_OK;
+}
+
+/**
+ * upload area of a full LCD_H_RES x LCD_V_RES frame buffer
+ * x_start, y_start include, x_end, y_end not include, x is aligned to byte
+ */
+esp_err_t
+epd_panel_draw_frame_area(int16_t x_start, int16_t y_start, int16_t x_end, int16_t y_end, const uint8_t *frame) {
+    wait_for_busy("before draw area");
+    if (x_start < 0) x_start = 0;
+    if (y_start < 0) y_start = 0;
+    if (x_end > LCD_H_RES) x_end = LCD_H_RES;
+    if (y_end > LCD_V_RES) y_end = LCD_V_RES;
+
+    // byte boundary
+    x_start -= x_start % 8;
+    if (x_end % 8 > 0) x_end += 8 - x_end % 8;
+
+    if (x_start >= x_end || y_start >= y_end) return ESP_OK;
 
+    set_mem_area(x_start, y_start, x_end, y_end);
+    set_mem_pointer(x_start, y_start);
+
+    const int stride = LCD_H_RES / 8;
+    write_ram_window(frame + y_start * stride + x_start / 8, stride, y_end - y_start, (x_end - x_start) / 8);
+
+    ESP_LOGI(TAG, "draw area x:%d y:%d end_x:%d end_y:%d", x_start, y_start, x_end, y_end);
     return ESP_OK;
 }
 
+esp_err_t epd_panel_wait_transfer_done() {
+    return wait_queued_trans(0, portMAX_DELAY);
+}
+
+bool epd_panel_is_transfer_done() {
+    wait_queued_trans(0, 0);
+    return queued_trans_count == 0;
+}
+
 esp_err_t epd_panel_refresh(bool full_refresh, bool waitdone) {
     wait_for_busy(full_refresh ? "before full refresh" : "before partial refresh");
     ESP_LOGI(TAG, "request refresh mode %s", full_refresh ? "full" : "partial");
@@ -458,11 +767,10 @@ epd_panel_refresh_area(int16_t x, int16_t y, int16_t end_x, int16_t end_y, bool
     return ESP_OK;
 }
 
-esp_err_t epd_panel_init(epd_refresh_mode_t mode) {
-    if (panel.refresh_mode == mode) {
-        return ESP_OK;
-    }
-
+/**
+ * SW reset and registers same for all refresh modes
+ */
+static void epd_panel_init_base() {
     // SW Reset by Command 0x12
     // wait_for_busy("pre init");
     epd_panel_sw_reset();
@@ -494,32 +802,59 @@ esp_err_t epd_panel_init(epd_refresh_mode_t mode) {
 
     set_mem_area(0, 0, LCD_H_RES, LCD_V_RES);
     set_mem_pointer(0, 0);
+    panel._base_configured = true;
+}
+
+esp_err_t epd_panel_init(epd_refresh_mode_t mode) {
+    uint8_t band = get_temperature_band(panel.temperature);
+    if (panel.refresh_mode == mode && panel._lut_band == band) {
+        return ESP_OK;
+    }
+    bool mode_changed = panel.refresh_mode != mode;
+    // registers can not be written while panel is refreshing
+    wait_for_busy("before init");
+
+    // registers keep value until reset, only first init after reset need SW reset and base config
+    if (!panel._base_configured) {
+        epd_panel_init_base();
+    }
 
     if (mode == EPD_REFRESH_MODE_FULL) {
-        set_lut_by_host(WF_Full_1IN54, 153);
-        lcd_cmd(0x3f, &WF_Full_1IN54[153], 1);
-        lcd_cmd(0x03, &WF_Full_1IN54[154], 1);
-        lcd_cmd(0x04, &WF_Full_1IN54[155], 3);
-        lcd_cmd(0x2C, &WF_Full_1IN54[158], 1);
+        const uint8_t *wf = get_band_waveform(mode, band);
+        set_lut_by_host(wf, WF_LUT_SIZE);
+        lcd_cmd_cached(0x3f, &wf[153], 1);
+        lcd_cmd_cached(SSD1680_CMD_GATE_DRIVING_VOLTAGE_CONTROL, &wf[154], 1);
+        lcd_cmd_cached(SSD1680_CMD_SOURCE_DRIVING_VOLTAGE_CONTROL, &wf[155], 3);
+        lcd_cmd_cached(SSD1680_CMD_WRITE_VCOM_REGISTER, &wf[158], 1);
+
+        // PingPong off, value after SW reset
+        lcd_cmd_cached(SSD1680_CMD_WRITE_DISPLAY_OPTIONAL, (uint8_t[]) {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 10);
+        // window of last partial refresh may be left
+        set_mem_area(0, 0, LCD_H_RES, LCD_V_RES);
         panel.refresh_mode = EPD_REFRESH_MODE_FULL;
     } else {
-        set_lut_by_host(WF_PARTIAL_1IN54, 153);
-        lcd_cmd(0x3f, &WF_PARTIAL_1IN54[153], 1);
-        lcd_cmd(0x03, &WF_PARTIAL_1IN54[154], 1);
-        lcd_cmd(0x04, &WF_PARTIAL_1IN54[155], 3);
-        lcd_cmd(0x2C, &WF_PARTIAL_1IN54[158], 1);
+        const uint8_t *wf = get_band_waveform(mode, band);
+        set_lut_by_host(wf, WF_LUT_SIZE);
+        lcd_cmd_cached(0x3f, &wf[153], 1);
+        lcd_cmd_cached(SSD1680_CMD_GATE_DRIVING_VOLTAGE_CONTROL, &wf[154], 1);
+        lcd_cmd_cached(SSD1680_CMD_SOURCE_DRIVING_VOLTAGE_CONTROL, &wf[155], 3);
+        lcd_cmd_cached(SSD1680_CMD_WRITE_VCOM_REGISTER, &wf[158], 1);
 
         // PingPong for Display Mode 2
-        lcd_cmd(SSD1680_CMD_WRITE_DISPLAY_OPTIONAL, (uint8_t[]) {0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x00}, 10);
+        lcd_cmd_cached(SSD1680_CMD_WRITE_DISPLAY_OPTIONAL, (uint8_t[]) {0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x00}, 10);
 
-        //c0 cf
-        lcd_cmd(SSD1680_CMD_DISPLAY_UPDATE_CONTROL_2, (uint8_t[]) {0xCF}, 1);
-        lcd_cmd(SSD1680_CMD_MASTER_ACTIVATION, NULL, 0);
-        wait_for_busy("init partial");
+        if (mode_changed) {
+            //c0 cf
+            lcd_cmd_cached(SSD1680_CMD_DISPLAY_UPDATE_CONTROL_2, (uint8_t[]) {0xCF}, 1);
+            lcd_cmd(SSD1680_CMD_MASTER_ACTIVATION, NULL, 0);
+            wait_for_busy("init partial");
+        }
         panel.refresh_mode = EPD_REFRESH_MODE_PARTIAL;
     }
+    panel._lut_band = band;
 
-    ESP_LOGI(TAG, "ssd1680 init %s mode success!", mode == EPD_REFRESH_MODE_FULL ? "full" : "partial");
+    ESP_LOGI(TAG, "ssd1680 init %s mode success! temperature %d band %d",
+             mode == EPD_REFRESH_MODE_FULL ? "full" : "partial", panel.temperature, band);
     return ESP_OK;
 }
 
@@ -530,25 +865,41 @@ esp_err_t epd_panel_sleep() {
     // 0x11 deep sleep mode 2 ram不保存
     // deep sleep mode 需要HWRESET唤醒
     lcd_cmd(SSD1680_CMD_DEEP_SLEEP_MODE, (uint8_t[]) {0x11}, 1);
+    // registers lost, wake up by HWRESET configure all again
+    reset_panel_state();
     ESP_LOGI(TAG, "ssd1680 enter sleep mode");
     return ESP_OK;
 }
 
 esp_err_t epd_panel_del() {
+    if (panel.spi_dev != NULL) {
+        wait_queued_trans(0, portMAX_DELAY);
+    }
+
     if (panel.reset_gpio_num >= 0) {
         gpio_reset_pin(panel.reset_gpio_num);
     }
 
+    gpio_isr_handler_remove(panel.busy_gpio_num);
     gpio_reset_pin(panel.busy_gpio_num);
+    busy_done_cb = NULL;
+    busy_done_cb_arg = NULL;
 
     if (panel.dc_gpio_num >= 0) {
         gpio_reset_pin(panel.dc_gpio_num);
     }
 
-    if (busySemaphore != NULL) {
-        vSemaphoreDelete(busySemaphore);
-        busySemaphore = NULL;
+    free(staging_buff);
+    staging_buff = NULL;
+    staging_buff_size = 0;
+
+    for (int m = 0; m < 2; m++) {
+        for (int b = 0; b < WF_TEMPERATURE_BAND_COUNT; b++) {
+            free(wf_band_luts[m][b]);
+            wf_band_luts[m][b] = NULL;
+        }
     }
+    reset_panel_state();
 
     return ESP_OK;
 }
\ No newline at end of file
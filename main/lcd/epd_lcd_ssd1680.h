@@ -21,12 +21,26 @@ extern "C" {
 #define DISP_RST_GPIO_NUM 25
 #define DISP_BUSY_GPIO_NUM 10
 
+// temperature not known, use stock waveform
+#define EPD_TEMPERATURE_UNKNOWN INT8_MIN
+
 typedef enum {
     EPD_REFRESH_MODE_UNSET = 0,
     EPD_REFRESH_MODE_FULL,
     EPD_REFRESH_MODE_PARTIAL
 } epd_refresh_mode_t;
 
+// max parameter bytes of a cached register
+#define SSD1680_REG_CACHE_DATA_SIZE 10
+#define SSD1680_REG_CACHE_SIZE 10
+
+// last parameters written to a register since reset
+typedef struct {
+    uint8_t cmd;
+    uint8_t len;
+    uint8_t data[SSD1680_REG_CACHE_DATA_SIZE];
+} ssd1680_reg_cache_t;
+
 typedef struct {
     spi_device_handle_t spi_dev;
     int busy_gpio_num; /*! LOW: idle, HIGH: busy */
@@ -35,6 +49,8 @@ typedef struct {
     bool reset_level;
 
     epd_refresh_mode_t refresh_mode;
+    // ambient temperature used to pick waveform band
+    int8_t temperature;
 
     int _current_mem_area_start_x;
     int _current_mem_area_end_x;
@@ -42,6 +58,13 @@ typedef struct {
     int _current_mem_area_end_y;
     int _current_mem_pointer_x;
     int _current_mem_pointer_y;
+
+    // registers state since last reset, mode switch only writes what differs
+    bool _base_configured;
+    const uint8_t *_current_lut;
+    uint8_t _lut_band;
+    uint8_t _reg_cache_count;
+    ssd1680_reg_cache_t _reg_cache[SSD1680_REG_CACHE_SIZE];
 } lcd_ssd1680_panel_t;
 
 /**
@@ -61,11 +84,61 @@ esp_err_t epd_panel_init(epd_refresh_mode_t mode);
 
 esp_err_t epd_panel_reset();
 
+/**
+ * set ambient temperature in celsius, EPD_TEMPERATURE_UNKNOWN for stock waveform.
+ * waveform of the temperature band is loaded on next epd_panel_init if band changed
+ */
+void epd_panel_set_temperature(int8_t temperature);
+
+/**
+ * fill b/w ram, and red ram if clear_red (old frame of ping-pong partial mode), no refresh.
+ * 0x00 / 0xFF are filled by panel auto write without sending data
+ */
+esp_err_t epd_panel_clear_ram(uint8_t color, bool clear_red);
+
+/**
+ * clear b/w ram and refresh
+ */
 esp_err_t epd_panel_clear_display(uint8_t color);
 
+/**
+ * ram data is sent by spi dma in background,
+ * color_data / frame must not be changed before epd_panel_wait_transfer_done or next panel command
+ */
 esp_err_t epd_panel_draw_bitmap(int16_t x_start, int16_t y_start, int16_t x_end, int16_t y_end,
                                            const void *color_data) ;
 
+esp_err_t epd_panel_draw_frame_area(int16_t x_start, int16_t y_start, int16_t x_end, int16_t y_end,
+                                    const uint8_t *frame);
+
+/**
+ * block until all ram data queued by draw are sent
+ */
+esp_err_t epd_panel_wait_transfer_done();
+
+/**
+ * return true if no ram data in flight, never block
+ */
+bool epd_panel_is_transfer_done();
+
+// task notification index the busy wait blocks on, the calling task must not use it for anything else
+#define EPD_PANEL_BUSY_NOTIFY_INDEX 1
+
+/**
+ * busy done callback, called in isr when busy line goes low, must be short and IRAM safe
+ */
+typedef void (*epd_panel_busy_done_cb_t)(void *arg);
+
+/**
+ * return true if panel is running a command (refresh / reset), never block
+ */
+bool epd_panel_is_busy();
+
+/**
+ * set callback for busy done, NULL to remove
+ */
+void epd_panel_register_busy_done_cb(epd_panel_busy_done_cb_t cb, void *arg);
+
 esp_err_t epd_panel_refresh(bool full_refresh, bool waitdone);
 
 esp_err_t epd_panel_refresh_area(int16_t x, int16_t y, int16_t end_x, int16_t end_y, bool waitdone);
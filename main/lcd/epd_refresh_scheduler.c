@@ -0,0 +1,58 @@
+#include <string.h>
+
+#include "esp_log.h"
+
+#include "epd_lcd_ssd1680.h"
+#include "epd_refresh_scheduler.h"
+
+#define TAG "refresh_scheduler"
+
+#define REFRESH_TILES_X ((LCD_H_RES + REFRESH_TILE_SIZE - 1) / REFRESH_TILE_SIZE)
+#define REFRESH_TILES_Y ((LCD_V_RES + REFRESH_TILE_SIZE - 1) / REFRESH_TILE_SIZE)
+
+static uint8_t tile_refresh_cnt[REFRESH_TILES_Y][REFRESH_TILES_X];
+static uint8_t max_tile_refresh_cnt = 0;
+
+bool epd_refresh_scheduler_need_full(epd_update_request_t request) {
+    switch (request) {
+        case EPD_UPDATE_CLEAN:
+            return true;
+        case EPD_UPDATE_NO_FLASH:
+            return max_tile_refresh_cnt >= REFRESH_TILE_GHOST_HARD_LIMIT;
+        default:
+            return max_tile_refresh_cnt >= REFRESH_TILE_GHOST_LIMIT;
+    }
+}
+
+void epd_refresh_scheduler_on_full_refresh() {
+    memset(tile_refresh_cnt, 0, sizeof(tile_refresh_cnt));
+    max_tile_refresh_cnt = 0;
+}
+
+void epd_refresh_scheduler_on_partial_refresh(int x, int y, int end_x, int end_y) {
+    if (x < 0) x = 0;
+    if (y < 0) y = 0;
+    if (end_x > LCD_H_RES) end_x = LCD_H_RES;
+    if (end_y > LCD_V_RES) end_y = LCD_V_RES;
+    if (x >= end_x || y >= end_y) {
+        return;
+    }
+
+    for (int ty = y / REFRESH_TILE_SIZE; ty <= (end_y - 1) / REFRESH_TILE_SIZE; ty++) {
+        for (int tx = x / REFRESH_TILE_SIZE; tx <= (end_x - 1) / REFRESH_TILE_SIZE; tx++) {
+            uint8_t cnt = tile_refresh_cnt[ty][tx];
+            if (cnt < UINT8_MAX) {
+                cnt++;
+                tile_refresh_cnt[ty][tx] = cnt;
+            }
+            if (cnt > max_tile_refresh_cnt) {
+                max_tile_refresh_cnt = cnt;
+            }
+        }
+    }
+    ESP_LOGD(TAG, "partial refresh (%d,%d)-(%d,%d), max tile count %d", x, y, end_x, end_y, max_tile_refresh_cnt);
+}
+
+uint8_t epd_refresh_scheduler_max_count() {
+    return max_tile_refresh_cnt;
+}
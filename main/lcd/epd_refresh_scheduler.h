@@ -0,0 +1,44 @@
+#ifndef EPD_REFRESH_SCHEDULER_H
+#define EPD_REFRESH_SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// screen is split to tiles, every tile counts partial refresh since last full refresh
+#define REFRESH_TILE_SIZE 25
+
+// full refresh if any tile partial refreshed so many times
+#define REFRESH_TILE_GHOST_LIMIT 60
+
+// no flash request can go over limit until this
+#define REFRESH_TILE_GHOST_HARD_LIMIT 120
+
+typedef enum {
+    EPD_UPDATE_NORMAL = 0,
+    // full refresh now, remove ghosting
+    EPD_UPDATE_CLEAN,
+    // keep partial refresh even ghosting over budget, for fast interaction
+    EPD_UPDATE_NO_FLASH,
+} epd_update_request_t;
+
+/**
+ * return true if next refresh should be full refresh
+ */
+bool epd_refresh_scheduler_need_full(epd_update_request_t request);
+
+/**
+ * clear all tile counters after full refresh
+ */
+void epd_refresh_scheduler_on_full_refresh();
+
+/**
+ * count partial refresh of area, x y include, end_x end_y not include
+ */
+void epd_refresh_scheduler_on_partial_refresh(int x, int y, int end_x, int end_y);
+
+/**
+ * max partial refresh count of all tiles
+ */
+uint8_t epd_refresh_scheduler_max_count();
+
+#endif
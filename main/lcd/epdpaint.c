@@ -4,19 +4,142 @@
 #include "epdpaint.h"
 #include "bmp.h"
 #include "jpg.h"
+#include "epi.h"
+#include "dither.h"
 #include "common_utils.h"
 #include "esp_log.h"
 
 #define TAG "epd_paint"
 
+typedef enum {
+    SPAN_OP_SET = 0, // set bits to 1
+    SPAN_OP_RESET, // set bits to 0
+    SPAN_OP_REVERSE, // flip bits
+} span_op_t;
+
 void epd_paint_draw_absolute_pixel(epd_paint_t *epd_paint, int x, int y, uint8_t colored);
 
 void epd_paint_draw_char_at(epd_paint_t *epd_paint, int x, int y, char ascii_char, sFONT *font, int colored);
 
 void epd_paint_draw_chinese_char_at(epd_paint_t *epd_paint, int x, int y, uint16_t font_char, sFONT *font, int colored);
 
+static inline void mark_dirty(epd_paint_t *epd_paint, int x, int y, int end_x, int end_y) {
+    if (x < epd_paint->dirty_x) epd_paint->dirty_x = x;
+    if (y < epd_paint->dirty_y) epd_paint->dirty_y = y;
+    if (end_x > epd_paint->dirty_end_x) epd_paint->dirty_end_x = end_x;
+    if (end_y > epd_paint->dirty_end_y) epd_paint->dirty_end_y = end_y;
+}
+
+/**
+ *  @brief: write one bit of the frame buffer, x y must be in range.
+ */
+static inline void write_absolute_pixel(epd_paint_t *epd_paint, int x, int y, int colored) {
+    mark_dirty(epd_paint, x, y, x + 1, y + 1);
+    uint8_t *p = &epd_paint->image[y * epd_paint->stride + (x >> 3)];
+    if ((colored != 0) == (IF_INVERT_COLOR != 0)) {
+        *p |= 0x80 >> (x & 7);
+    } else {
+        *p &= ~(0x80 >> (x & 7));
+    }
+}
+
+static inline uint8_t read_absolute_pixel(epd_paint_t *epd_paint, int x, int y) {
+    return epd_paint->image[y * epd_paint->stride + (x >> 3)] & (0x80 >> (x & 7));
+}
+
+// pixel writers for each rotation. mapped pixel must be inside frame, so y == 0 of ROTATE_90,
+// x == 0 or y == 0 of ROTATE_180 and x == 0 of ROTATE_270 are dropped, they map to column width or row height
+static void draw_pixel_rotate_0(epd_paint_t *epd_paint, int x, int y, int colored) {
+    if ((unsigned) x >= (unsigned) epd_paint->width || (unsigned) y >= (unsigned) epd_paint->height) {
+        return;
+    }
+    write_absolute_pixel(epd_paint, x, y, colored);
+}
+
+static void draw_pixel_rotate_90(epd_paint_t *epd_paint, int x, int y, int colored) {
+    // x' = width - y, y' = x
+    if ((unsigned) x >= (unsigned) epd_paint->height || y <= 0 || y >= epd_paint->width) {
+        return;
+    }
+    write_absolute_pixel(epd_paint, epd_paint->width - y, x, colored);
+}
+
+static void draw_pixel_rotate_180(epd_paint_t *epd_paint, int x, int y, int colored) {
+    // x' = width - x, y' = height - y
+    if (x <= 0 || x >= epd_paint->width || y <= 0 || y >= epd_paint->height) {
+        return;
+    }
+    write_absolute_pixel(epd_paint, epd_paint->width - x, epd_paint->height - y, colored);
+}
+
+static void draw_pixel_rotate_270(epd_paint_t *epd_paint, int x, int y, int colored) {
+    // x' = y, y' = height - x
+    if (x <= 0 || x >= epd_paint->height || (unsigned) y >= (unsigned) epd_paint->width) {
+        return;
+    }
+    write_absolute_pixel(epd_paint, y, epd_paint->height - x, colored);
+}
+
+static uint8_t get_pixel_rotate_0(epd_paint_t *epd_paint, int x, int y) {
+    if ((unsigned) x >= (unsigned) epd_paint->width || (unsigned) y >= (unsigned) epd_paint->height) {
+        return 0;
+    }
+    return read_absolute_pixel(epd_paint, x, y);
+}
+
+static uint8_t get_pixel_rotate_90(epd_paint_t *epd_paint, int x, int y) {
+    if ((unsigned) x >= (unsigned) epd_paint->height || y <= 0 || y >= epd_paint->width) {
+        return 0;
+    }
+    return read_absolute_pixel(epd_paint, epd_paint->width - y, x);
+}
 
-uint8_t epd_paint_get_pixel(epd_paint_t *epd_paint, int x, int y);
+static uint8_t get_pixel_rotate_180(epd_paint_t *epd_paint, int x, int y) {
+    if (x <= 0 || x >= epd_paint->width || y <= 0 || y >= epd_paint->height) {
+        return 0;
+    }
+    return read_absolute_pixel(epd_paint, epd_paint->width - x, epd_paint->height - y);
+}
+
+static uint8_t get_pixel_rotate_270(epd_paint_t *epd_paint, int x, int y) {
+    if (x <= 0 || x >= epd_paint->height || (unsigned) y >= (unsigned) epd_paint->width) {
+        return 0;
+    }
+    return read_absolute_pixel(epd_paint, y, epd_paint->height - x);
+}
+
+/**
+ *  @brief: select pixel writers for current rotation, so draw pixel needn't switch every time.
+ */
+static void epd_paint_setup_rotation(epd_paint_t *epd_paint) {
+    epd_paint->stride = epd_paint->width / 8;
+    switch (epd_paint->rotate) {
+        case ROTATE_90:
+            epd_paint->draw_pixel = draw_pixel_rotate_90;
+            epd_paint->get_pixel = get_pixel_rotate_90;
+            break;
+        case ROTATE_180:
+            epd_paint->draw_pixel = draw_pixel_rotate_180;
+            epd_paint->get_pixel = get_pixel_rotate_180;
+            break;
+        case ROTATE_270:
+            epd_paint->draw_pixel = draw_pixel_rotate_270;
+            epd_paint->get_pixel = get_pixel_rotate_270;
+            break;
+        default:
+            epd_paint->draw_pixel = draw_pixel_rotate_0;
+            epd_paint->get_pixel = get_pixel_rotate_0;
+            break;
+    }
+
+    if (epd_paint->rotate == ROTATE_90 || epd_paint->rotate == ROTATE_270) {
+        epd_paint->rotated_width = epd_paint->height;
+        epd_paint->rotated_height = epd_paint->width;
+    } else {
+        epd_paint->rotated_width = epd_paint->width;
+        epd_paint->rotated_height = epd_paint->height;
+    }
+}
 
 void epd_paint_init(epd_paint_t *epd_paint, unsigned char *image, int width, int height, uint8_t rotate) {
     epd_paint->rotate = rotate;
@@ -24,10 +147,15 @@ void epd_paint_init(epd_paint_t *epd_paint, unsigned char *image, int width, int
     /* 1 byte = 8 pixels, so the width should be the multiple of 8 */
     epd_paint->width = width % 8 ? width + 8 - (width % 8) : width;
     epd_paint->height = height;
+    epd_paint_setup_rotation(epd_paint);
+    // panel ram content is unknown, the first frame is all dirty
+    epd_paint_reset_dirty(epd_paint);
+    epd_paint_mark_dirty(epd_paint, 0, 0, epd_paint->width, epd_paint->height);
 }
 
 void epd_paint_set_rotation(epd_paint_t *epd_paint, uint8_t rotate) {
     epd_paint->rotate = rotate;
+    epd_paint_setup_rotation(epd_paint);
 }
 
 void epd_paint_deinit(epd_paint_t *epd_paint) {
@@ -35,10 +163,44 @@ void epd_paint_deinit(epd_paint_t *epd_paint) {
     epd_paint->image = NULL;
 }
 
+void epd_paint_reset_dirty(epd_paint_t *epd_paint) {
+    epd_paint->dirty_x = epd_paint->width;
+    epd_paint->dirty_y = epd_paint->height;
+    epd_paint->dirty_end_x = 0;
+    epd_paint->dirty_end_y = 0;
+}
+
+/**
+ *  @brief: mark absolute area [x, end_x) x [y, end_y) as changed,
+ *          for who writes epd_paint->image directly.
+ */
+void epd_paint_mark_dirty(epd_paint_t *epd_paint, int x, int y, int end_x, int end_y) {
+    x = max(x, 0);
+    y = max(y, 0);
+    end_x = min(end_x, epd_paint->width);
+    end_y = min(end_y, epd_paint->height);
+    if (x >= end_x || y >= end_y) {
+        return;
+    }
+    mark_dirty(epd_paint, x, y, end_x, end_y);
+}
+
+bool epd_paint_get_dirty_area(epd_paint_t *epd_paint, int *x, int *y, int *end_x, int *end_y) {
+    if (epd_paint->dirty_x >= epd_paint->dirty_end_x || epd_paint->dirty_y >= epd_paint->dirty_end_y) {
+        return false;
+    }
+    *x = epd_paint->dirty_x & ~7;
+    *y = epd_paint->dirty_y;
+    *end_x = min((epd_paint->dirty_end_x + 7) & ~7, epd_paint->width);
+    *end_y = epd_paint->dirty_end_y;
+    return true;
+}
+
 /**
  *  @brief: clear the image
  */
 void epd_paint_clear(epd_paint_t *epd_paint, int colored) {
+    mark_dirty(epd_paint, 0, 0, epd_paint->width, epd_paint->height);
     if (IF_INVERT_COLOR) {
         if (colored) {
             memset(epd_paint->image, 0xff, epd_paint->width * epd_paint->height * sizeof(uint8_t) / 8);
@@ -60,26 +222,123 @@ void epd_paint_clear(epd_paint_t *epd_paint, int colored) {
 //    }
 }
 
-void epd_paint_clear_range(epd_paint_t *epd_paint, int start_x, int start_y, int width, int height, int colored) {
-    for (int x = start_x; x < min(start_x + width, epd_paint->width); x++) {
-        for (int y = start_y; y < min(start_y + height, epd_paint->height); y++) {
-            epd_paint_draw_pixel(epd_paint, x, y, colored);
+/**
+ *  @brief: fill absolute range [x0, x1) x [y0, y1) row by row,
+ *          whole bytes by memset and the partial edge bytes by mask.
+ *          this function won't be affected by the rotate parameter.
+ */
+static void epd_paint_fill_absolute_span(epd_paint_t *epd_paint, int x0, int y0, int x1, int y1, span_op_t op) {
+    x0 = max(x0, 0);
+    y0 = max(y0, 0);
+    x1 = min(x1, epd_paint->width);
+    y1 = min(y1, epd_paint->height);
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+    mark_dirty(epd_paint, x0, y0, x1, y1);
+
+    int stride = epd_paint->stride;
+    int start_byte = x0 / 8;
+    int end_byte = (x1 - 1) / 8;
+    uint8_t start_mask = 0xff >> (x0 % 8);
+    uint8_t end_mask = 0xff << (7 - (x1 - 1) % 8);
+    if (start_byte == end_byte) {
+        start_mask &= end_mask;
+    }
+
+    // whole bytes between the two edge bytes
+    int full_start = start_byte + 1;
+    int full_len = end_byte - start_byte - 1;
+
+    uint8_t *row = epd_paint->image + y0 * stride;
+    for (int y = y0; y < y1; y++, row += stride) {
+        switch (op) {
+            case SPAN_OP_SET:
+                row[start_byte] |= start_mask;
+                if (full_len > 0) {
+                    memset(row + full_start, 0xff, full_len);
+                }
+                if (start_byte != end_byte) {
+                    row[end_byte] |= end_mask;
+                }
+                break;
+            case SPAN_OP_RESET:
+                row[start_byte] &= ~start_mask;
+                if (full_len > 0) {
+                    memset(row + full_start, 0x00, full_len);
+                }
+                if (start_byte != end_byte) {
+                    row[end_byte] &= ~end_mask;
+                }
+                break;
+            case SPAN_OP_REVERSE:
+                row[start_byte] ^= start_mask;
+                for (int i = full_start; i < full_start + full_len; i++) {
+                    row[i] ^= 0xff;
+                }
+                if (start_byte != end_byte) {
+                    row[end_byte] ^= end_mask;
+                }
+                break;
         }
     }
 }
 
-void epd_paint_reverse_range(epd_paint_t *epd_paint, int start_x, int start_y, int width, int height) {
-    for (int x = start_x; x < min(start_x + width, epd_paint->width); x++) {
-        for (int y = start_y; y < min(start_y + height, epd_paint->height); y++) {
-            if (epd_paint_get_pixel(epd_paint, x, y)) { // bit is 1
-                epd_paint_draw_pixel(epd_paint, x, y, 1);
-            } else {
-                epd_paint_draw_pixel(epd_paint, x, y, 0);
-            }
-        }
+/**
+ *  @brief: fill range [x0, x1) x [y0, y1) by the coordinates,
+ *          map it to the absolute range once then fill by spans.
+ *          result is same as call epd_paint_draw_pixel for every pixel in range.
+ */
+static void epd_paint_fill_span(epd_paint_t *epd_paint, int x0, int y0, int x1, int y1, span_op_t op) {
+    x0 = max(x0, 0);
+    y0 = max(y0, 0);
+    x1 = min(x1, epd_paint->rotated_width);
+    y1 = min(y1, epd_paint->rotated_height);
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    int w = epd_paint->width;
+    int h = epd_paint->height;
+    switch (epd_paint->rotate) {
+        case ROTATE_90:
+            // x' = width - y, y' = x
+            epd_paint_fill_absolute_span(epd_paint, w - y1 + 1, x0, w - y0 + 1, x1, op);
+            break;
+        case ROTATE_180:
+            // x' = width - x, y' = height - y
+            epd_paint_fill_absolute_span(epd_paint, w - x1 + 1, h - y1 + 1, w - x0 + 1, h - y0 + 1, op);
+            break;
+        case ROTATE_270:
+            // x' = y, y' = height - x
+            epd_paint_fill_absolute_span(epd_paint, y0, h - x1 + 1, y1, h - x0 + 1, op);
+            break;
+        default:
+            epd_paint_fill_absolute_span(epd_paint, x0, y0, x1, y1, op);
+            break;
+    }
+}
+
+static inline span_op_t color_span_op(int colored) {
+    if (IF_INVERT_COLOR) {
+        return colored ? SPAN_OP_SET : SPAN_OP_RESET;
+    } else {
+        return colored ? SPAN_OP_RESET : SPAN_OP_SET;
     }
 }
 
+void epd_paint_clear_range(epd_paint_t *epd_paint, int start_x, int start_y, int width, int height, int colored) {
+    epd_paint_fill_span(epd_paint, start_x, start_y,
+                        min(start_x + width, epd_paint->width), min(start_y + height, epd_paint->height),
+                        color_span_op(colored));
+}
+
+void epd_paint_reverse_range(epd_paint_t *epd_paint, int start_x, int start_y, int width, int height) {
+    epd_paint_fill_span(epd_paint, start_x, start_y,
+                        min(start_x + width, epd_paint->width), min(start_y + height, epd_paint->height),
+                        SPAN_OP_REVERSE);
+}
+
 /**
  *  @brief: draws a pixel by absolute coordinates.
  *          this function won't be affected by the rotate parameter.
@@ -88,85 +347,155 @@ void epd_paint_draw_absolute_pixel(epd_paint_t *epd_paint, int x, int y, uint8_t
     if (x < 0 || x >= epd_paint->width || y < 0 || y >= epd_paint->height) {
         return;
     }
-    if (IF_INVERT_COLOR) {
-        if (colored) {
-            epd_paint->image[(x + y * epd_paint->width) / 8] |= 0x80 >> (x % 8);
-        } else {
-            epd_paint->image[(x + y * epd_paint->width) / 8] &= ~(0x80 >> (x % 8));
-        }
-    } else {
-        if (colored) {
-            epd_paint->image[(x + y * epd_paint->width) / 8] &= ~(0x80 >> (x % 8));
-        } else {
-            epd_paint->image[(x + y * epd_paint->width) / 8] |= 0x80 >> (x % 8);
-        }
-    }
+    write_absolute_pixel(epd_paint, x, y, colored);
 }
 
 uint8_t epd_paint_get_pixel(epd_paint_t *epd_paint, int x, int y) {
-    int point_temp;
-    if (epd_paint->rotate == ROTATE_0) {
-        if (x < 0 || x >= epd_paint->width || y < 0 || y >= epd_paint->height) {
-            return 0;
+    return epd_paint->get_pixel(epd_paint, x, y);
+}
+
+/**
+ *  @brief: epd_paint draws a pixel by the coordinates
+ */
+void epd_paint_draw_pixel(epd_paint_t *epd_paint, int x, int y, int colored) {
+    epd_paint->draw_pixel(epd_paint, x, y, colored);
+}
+
+static void draw_glyph_by_pixel(epd_paint_t *epd_paint, int x, int y, const uint8_t *ptr,
+                                int glyph_width, int glyph_height, int colored) {
+    int i, j;
+    for (j = 0; j < glyph_height; j++) {
+        for (i = 0; i < glyph_width; i++) {
+            if (*ptr & (0x80 >> (i % 8))) {
+                epd_paint->draw_pixel(epd_paint, x + i, y + j, colored);
+            }
+            if (i % 8 == 7) {
+                ptr++;
+            }
         }
-    } else if (epd_paint->rotate == ROTATE_90) {
-        if (x < 0 || x >= epd_paint->height || y < 0 || y >= epd_paint->width) {
-            return 0;
+        if (glyph_width % 8 != 0) {
+            ptr++;
         }
-        point_temp = x;
-        x = epd_paint->width - y;
-        y = point_temp;
-    } else if (epd_paint->rotate == ROTATE_180) {
-        if (x < 0 || x >= epd_paint->width || y < 0 || y >= epd_paint->height) {
-            return 0;
+    }
+}
+
+static inline uint32_t reverse_bits_32(uint32_t v) {
+    v = ((v >> 1) & 0x55555555) | ((v & 0x55555555) << 1);
+    v = ((v >> 2) & 0x33333333) | ((v & 0x33333333) << 2);
+    v = ((v >> 4) & 0x0F0F0F0F) | ((v & 0x0F0F0F0F) << 4);
+    v = ((v >> 8) & 0x00FF00FF) | ((v & 0x00FF00FF) << 8);
+    return (v >> 16) | (v << 16);
+}
+
+/**
+ *  @brief: merge up to 32 pixels into one absolute row, msb of bits is pixel at x.
+ *          only set bits are drawn, pixels out of [min_x, width) are dropped.
+ */
+static void blit_absolute_row_bits(epd_paint_t *epd_paint, int x, int y, uint32_t bits, int min_x, int colored) {
+    if (y < 0 || y >= epd_paint->height) {
+        return;
+    }
+    // drop pixels out of range
+    if (x < min_x) {
+        bits = (min_x - x) >= 32 ? 0 : bits & (0xffffffffu >> (min_x - x));
+    }
+    if (x + 32 > epd_paint->width) {
+        bits = (x >= epd_paint->width) ? 0 : bits & (0xffffffffu << (x + 32 - epd_paint->width));
+    }
+    if (!bits) {
+        return;
+    }
+    mark_dirty(epd_paint, x + __builtin_clz(bits), y, x + 32 - __builtin_ctz(bits), y + 1);
+
+    int first_byte = x >> 3; // floor
+    uint64_t v = (uint64_t) bits << (32 - (x - first_byte * 8));
+    uint8_t *row = epd_paint->image + y * epd_paint->stride;
+    if (first_byte < 0) {
+        // bytes left of the row hold no pixel after clipping, start at row
+        v <<= -first_byte * 8;
+        first_byte = 0;
+    }
+    // trailing bytes with no pixel are not touched either, so no byte out of range is
+    uint8_t *p = row + first_byte;
+    if ((colored != 0) == (IF_INVERT_COLOR != 0)) {
+        for (; v; v <<= 8, p++) {
+            *p |= (uint8_t) (v >> 56);
         }
-        x = epd_paint->width - x;
-        y = epd_paint->height - y;
-    } else if (epd_paint->rotate == ROTATE_270) {
-        if (x < 0 || x >= epd_paint->height || y < 0 || y >= epd_paint->width) {
-            return 0;
+    } else {
+        for (; v; v <<= 8, p++) {
+            *p &= ~(uint8_t) (v >> 56);
         }
-        point_temp = x;
-        x = y;
-        y = epd_paint->height - point_temp;
     }
-    return epd_paint->image[(x + y * epd_paint->width) / 8] & (0x80 >> (x % 8));
 }
 
-
 /**
- *  @brief: epd_paint draws a pixel by the coordinates
+ *  @brief: draws a glyph (msb first, rows padded to byte) by whole rows.
+ *          ROTATE_0/180 merge every glyph row with shift,
+ *          ROTATE_90/270 transpose glyph to columns first then merge every column.
  */
-void epd_paint_draw_pixel(epd_paint_t *epd_paint, int x, int y, int colored) {
-    int point_temp;
-    if (epd_paint->rotate == ROTATE_0) {
-        if (x < 0 || x >= epd_paint->width || y < 0 || y >= epd_paint->height) {
-            return;
+static void epd_paint_draw_glyph(epd_paint_t *epd_paint, int x, int y, const uint8_t *ptr,
+                                 int glyph_width, int glyph_height, int colored) {
+    if (glyph_width > 32 || glyph_height > 32) {
+        draw_glyph_by_pixel(epd_paint, x, y, ptr, glyph_width, glyph_height, colored);
+        return;
+    }
+
+    int row_bytes = (glyph_width + 7) / 8;
+    uint32_t width_mask = 0xffffffffu << (32 - glyph_width);
+    uint32_t rows[32];
+    for (int j = 0; j < glyph_height; j++, ptr += row_bytes) {
+        uint32_t bits = 0;
+        for (int b = 0; b < row_bytes; b++) {
+            bits |= (uint32_t) ptr[b] << (24 - 8 * b);
         }
-        epd_paint_draw_absolute_pixel(epd_paint, x, y, colored);
-    } else if (epd_paint->rotate == ROTATE_90) {
-        if (x < 0 || x >= epd_paint->height || y < 0 || y >= epd_paint->width) {
-            return;
+        rows[j] = bits & width_mask;
+    }
+
+    int w = epd_paint->width;
+    int h = epd_paint->height;
+    if (epd_paint->rotate == ROTATE_0) {
+        for (int j = 0; j < glyph_height; j++) {
+            blit_absolute_row_bits(epd_paint, x, y + j, rows[j], 0, colored);
         }
-        point_temp = x;
-        x = epd_paint->width - y;
-        y = point_temp;
-        epd_paint_draw_absolute_pixel(epd_paint, x, y, colored);
+        return;
     } else if (epd_paint->rotate == ROTATE_180) {
-        if (x < 0 || x >= epd_paint->width || y < 0 || y >= epd_paint->height) {
-            return;
+        // x' = width - x, y' = height - y, row is mirrored
+        for (int j = 0; j < glyph_height; j++) {
+            if (y + j <= 0 || y + j >= h) {
+                continue;
+            }
+            blit_absolute_row_bits(epd_paint, w - (x + glyph_width - 1), h - (y + j),
+                                   reverse_bits_32(rows[j]) << (32 - glyph_width), 1, colored);
         }
-        x = epd_paint->width - x;
-        y = epd_paint->height - y;
-        epd_paint_draw_absolute_pixel(epd_paint, x, y, colored);
-    } else if (epd_paint->rotate == ROTATE_270) {
-        if (x < 0 || x >= epd_paint->height || y < 0 || y >= epd_paint->width) {
-            return;
+        return;
+    }
+
+    // transpose, cols[i] msb is glyph row 0
+    uint32_t cols[32] = {0};
+    for (int j = 0; j < glyph_height; j++) {
+        uint32_t bits = rows[j];
+        while (bits) {
+            int i = __builtin_clz(bits);
+            cols[i] |= 0x80000000u >> j;
+            bits &= ~(0x80000000u >> i);
+        }
+    }
+
+    for (int i = 0; i < glyph_width; i++) {
+        if (!cols[i] || x + i < 0) {
+            continue;
+        }
+        if (epd_paint->rotate == ROTATE_90) {
+            // x' = width - y, y' = x, column is mirrored
+            blit_absolute_row_bits(epd_paint, w - (y + glyph_height - 1), x + i,
+                                   reverse_bits_32(cols[i]) << (32 - glyph_height), 1, colored);
+        } else {
+            // x' = y, y' = height - x
+            if (x + i == 0 || x + i >= h) {
+                continue;
+            }
+            blit_absolute_row_bits(epd_paint, y, h - (x + i), cols[i], 0, colored);
         }
-        point_temp = x;
-        x = y;
-        y = epd_paint->height - point_temp;
-        epd_paint_draw_absolute_pixel(epd_paint, x, y, colored);
     }
 }
 
@@ -174,47 +503,17 @@ void epd_paint_draw_pixel(epd_paint_t *epd_paint, int x, int y, int colored) {
  *  @brief: draws a charactor on the frame buffer but not refresh
  */
 void epd_paint_draw_char_at(epd_paint_t *epd_paint, int x, int y, char ascii_char, sFONT *font, int colored) {
-    int i, j;
     unsigned int char_offset =
             (ascii_char - font->start) * font->Height * (font->Width / 8 + (font->Width % 8 ? 1 : 0));
-    const uint8_t *ptr = &font->table[char_offset];
-
-    for (j = 0; j < font->Height; j++) {
-        for (i = 0; i < font->Width; i++) {
-            if (*ptr & (0x80 >> (i % 8))) {
-                epd_paint_draw_pixel(epd_paint, x + i, y + j, colored);
-            }
-            if (i % 8 == 7) {
-                ptr++;
-            }
-        }
-        if (font->Width % 8 != 0) {
-            ptr++;
-        }
-    }
+    epd_paint_draw_glyph(epd_paint, x, y, &font->table[char_offset], font->Width, font->Height, colored);
 }
 
 // 0xA1A1~0xFEFE
 void
 epd_paint_draw_chinese_char_at(epd_paint_t *epd_paint, int x, int y, uint16_t font_char, sFONT *font, int colored) {
-    int i, j;
     unsigned int char_offset = (94 * (unsigned int) ((font_char & 0xff) - 0xa0 - 1) + ((font_char >> 8) - 0xa0 - 1))
                                * font->Height * (font->Width / 8 + (font->Width % 8 ? 1 : 0));
-    const uint8_t *ptr = &font->table[char_offset];
-
-    for (j = 0; j < font->Height; j++) {
-        for (i = 0; i < font->Width; i++) {
-            if (*ptr & (0x80 >> (i % 8))) {
-                epd_paint_draw_pixel(epd_paint, x + i, y + j, colored);
-            }
-            if (i % 8 == 7) {
-                ptr++;
-            }
-        }
-        if (font->Width % 8 != 0) {
-            ptr++;
-        }
-    }
+    epd_paint_draw_glyph(epd_paint, x, y, &font->table[char_offset], font->Width, font->Height, colored);
 }
 
 
@@ -331,10 +630,7 @@ void epd_paint_draw_line(epd_paint_t *epd_paint, int x0, int y0, int x1, int y1,
 *  @brief: epd_paint draws a horizontal line on the frame buffer
 */
 void epd_paint_draw_horizontal_line(epd_paint_t *epd_paint, int x, int y, int line_width, int colored) {
-    int i;
-    for (i = x; i < x + line_width; i++) {
-        epd_paint_draw_pixel(epd_paint, i, y, colored);
-    }
+    epd_paint_fill_span(epd_paint, x, y, x + line_width, y + 1, color_span_op(colored));
 }
 
 void epd_paint_draw_horizontal_doted_line(epd_paint_t *epd_paint, int x, int y, int line_width, int colored) {
@@ -354,10 +650,7 @@ void epd_paint_draw_horizontal_doted_line(epd_paint_t *epd_paint, int x, int y,
 *  @brief: draws a vertical line on the frame buffer
 */
 void epd_paint_draw_vertical_line(epd_paint_t *epd_paint, int x, int y, int line_height, int colored) {
-    int i;
-    for (i = y; i < y + line_height; i++) {
-        epd_paint_draw_pixel(epd_paint, x, i, colored);
-    }
+    epd_paint_fill_span(epd_paint, x, y, x + 1, y + line_height, color_span_op(colored));
 }
 
 void epd_paint_draw_vertical_doted_line(epd_paint_t *epd_paint, int x, int y, int line_height, int colored) {
@@ -405,15 +698,12 @@ void epd_paint_draw_doted_rectangle(epd_paint_t *epd_paint, int x0, int y0, int
 */
 void epd_paint_draw_filled_rectangle(epd_paint_t *epd_paint, int startx, int starty, int endx, int endy, int colored) {
     int min_x, min_y, max_x, max_y;
-    int i;
     min_x = endx > startx ? startx : endx;
     max_x = endx > startx ? endx : startx;
     min_y = endy > starty ? starty : endy;
     max_y = endy > starty ? endy : starty;
 
-    for (i = min_x; i <= max_x; i++) {
-        epd_paint_draw_vertical_line(epd_paint, i, min_y, max_y - min_y + 1, colored);
-    }
+    epd_paint_fill_span(epd_paint, min_x, min_y, max_x + 1, max_y + 1, color_span_op(colored));
 }
 
 void epd_paint_draw_circle(epd_paint_t *epd_paint, int x, int y, int radius, int colored) {
@@ -475,56 +765,45 @@ inline uint8_t bgr_to_gray(pixel_color c) {
     return (c.red * 30 + c.green * 59 + c.blue * 11) / 100;
 }
 
-inline uint8_t saturated_add(uint8_t val1, int8_t val2) {
-    int16_t tmp = (int16_t) val1 + (int16_t) val2;
-    if (tmp > 255) {
-        return 255;
-    } else if (tmp < 0) {
-        return 0;
-    } else {
-        return tmp;
-    }
-}
-
-void dither(uint8_t *gray_data, uint8_t width, uint8_t height) {
-    int err;
-    int8_t a, b, c, d;
-    for (int i = 0; i < width; i++) {
-        for (int j = 0; j < height; j++) {
-            if (gray_data[i * width + j] > 127) {
-                err = gray_data[i * width + j] - 255;
-                gray_data[i * width + j] = 255;
-            } else {
-                err = gray_data[i * width + j] - 0;
-                gray_data[i * width + j] = 0;
-            }
-
-            a = (err * 7) / 16;
-            b = (err * 1) / 16;
-            c = (err * 5) / 16;
-            d = (err * 3) / 16;
-
-            if ((i != (height - 1)) && (j != 0) && (j != (width - 1))) {
-                gray_data[i * width + j] = saturated_add(gray_data[i * width + j], a);
-                gray_data[(i + 1) * width + j + 1] = saturated_add(gray_data[(i + 1) * width + j + 1], b);
-                gray_data[(i + 1) * width + j] = saturated_add(gray_data[(i + 1) * width + j], c);
-                gray_data[(i + 1) * width + j - 1] = saturated_add(gray_data[(i + 1) * width + j - 1], d);
+/**
+ * copy width bits of a 1 bit bmp row from bit src_x into absolute row y from x, ROTATE_0 only.
+ * byte aligned rows are copied as they are, others are shift merged a frame buffer byte each time.
+ */
+static void copy_bits_row(epd_paint_t *epd_paint, int x, int y, const uint8_t *src, int src_x, int width,
+                          bool invert) {
+    mark_dirty(epd_paint, x, y, x + width, y + 1);
+    uint8_t *dst = &epd_paint->image[y * epd_paint->stride + (x >> 3)];
+    uint8_t flip = invert ? 0xff : 0x00;
+
+    if (!(x & 7) && !(src_x & 7)) {
+        src += src_x >> 3;
+        int bytes = width >> 3;
+        if (invert) {
+            for (int i = 0; i < bytes; i++) {
+                dst[i] = ~src[i];
             }
+        } else {
+            memcpy(dst, src, bytes);
+        }
+        if (width & 7) {
+            uint8_t mask = 0xff << (8 - (width & 7));
+            dst[bytes] = (dst[bytes] & ~mask) | ((src[bytes] ^ flip) & mask);
         }
+        return;
     }
-}
 
-static void
-draw_gray_color(epd_paint_t *epd_paint, int x, int y, int end_x, int end_y, const uint8_t *bmp_data, int colored) {
-    uint8_t gray_color;
-    for (int j = y; j < end_y; ++j) {
-        for (int i = x; i < end_x; ++i) {
-            gray_color = bmp_data[(j - y) * (end_x - x) + (i - x)];
-            if (!colored) {
-                gray_color = 255 - gray_color;
-            }
-            epd_paint_draw_pixel(epd_paint, i, j, gray_color >= 128 ? 0 : 1);
-        }
+    for (int i = 0; i < width;) {
+        int dst_bit = (x + i) & 7;
+        int n = min(8 - dst_bit, width - i);
+        int src_bit = src_x + i;
+        const uint8_t *s = src + (src_bit >> 3);
+        // next source byte only when bits cross it, last byte of row may be end of data
+        uint16_t w = (s[0] << 8) | (((src_bit & 7) + n > 8) ? s[1] : 0);
+        uint8_t bits = (uint8_t) ((w << (src_bit & 7)) >> 8) ^ flip;
+        uint8_t mask = (uint8_t) (0xff << (8 - n)) >> dst_bit;
+        *dst = (*dst & ~mask) | ((bits >> dst_bit) & mask);
+        dst++;
+        i += n;
     }
 }
 
@@ -549,6 +828,26 @@ void epd_paint_draw_bitmap(epd_paint_t *epd_paint, int x, int y, int width, int
         pixel_color out_color;
         uint8_t gray_color;
 
+        bool one_is_white;
+        uint16_t pad_line_byte = ((bmpHeader.biWidth + 31) & ~31) >> 3;
+        // size first, palette is read only when it is in data
+        if (epd_paint->rotate == ROTATE_0
+            && data_size >= bmpHeader.bfOffBits + pad_line_byte * abs(bmpHeader.biHeight)
+            && bmp_is_black_white(&bmpHeader, (const RGBQUAD *) (bmp_data + 14 + bmpHeader.biSize),
+                                  bmp_palette_count(&bmpHeader), &one_is_white)) {
+            int start_x = max(x, 0);
+            int end_x = min(x + bmpHeader.biWidth, epd_paint->width);
+            int end_y = min(y + abs(bmpHeader.biHeight), epd_paint->height);
+            // white is bit set in frame buffer unless IF_INVERT_COLOR
+            bool invert = (one_is_white != (colored != 0)) != (IF_INVERT_COLOR != 0);
+            for (int j = max(y, 0); j < end_y && start_x < end_x; ++j) {
+                int row = bmpHeader.biHeight < 0 ? j - y : bmpHeader.biHeight - 1 - (j - y);
+                copy_bits_row(epd_paint, start_x, j, bmp_data + bmpHeader.bfOffBits + row * pad_line_byte,
+                              start_x - x, end_x - start_x, invert);
+            }
+            return;
+        }
+
         uint16_t end_x = min(x + width, epd_paint->width);
         end_x = min(x + bmpHeader.biWidth, epd_paint->width);
 
@@ -596,100 +895,351 @@ void fill_err_color(pixel_color *out_color, uint16_t x, uint16_t y) {
     }
 }
 
-void epd_paint_draw_bitmap_file(epd_paint_t *epd_paint, int x, int y, int width, int height, FILE *file, int colored) {
-    if (y + height < 0 || y >= epd_paint->height || x >= epd_paint->width || x + width < 0) {
+/**
+ * write a row of 0 / 255, 255 is white. ROTATE_0 rows in range are whole bytes of frame buffer so merged by byte,
+ * others go by the clipping pixel writer.
+ */
+static void write_dithered_row(epd_paint_t *epd_paint, int x, int y, const uint8_t *bw, int width) {
+    if (epd_paint->rotate != ROTATE_0 || x < 0 || x + width > epd_paint->width
+        || (unsigned) y >= (unsigned) epd_paint->height) {
+        for (int i = 0; i < width; i++) {
+            epd_paint->draw_pixel(epd_paint, x + i, y, bw[i] ? 0 : 1);
+        }
         return;
     }
 
-    bmp_img_file_common bmp_header;
-    enum bmp_error err = bmp_header_read_file(&bmp_header, file);
+    mark_dirty(epd_paint, x, y, x + width, y + 1);
+    uint8_t *p = &epd_paint->image[y * epd_paint->stride + (x >> 3)];
+    int bit = x & 7;
+    uint8_t mask = 0, value = 0;
+    for (int i = 0; i < width; i++) {
+        mask |= 0x80 >> bit;
+        if ((bw[i] != 0) != (IF_INVERT_COLOR != 0)) {
+            value |= 0x80 >> bit;
+        }
+        if (++bit == 8) {
+            *p = (*p & ~mask) | value;
+            p++;
+            bit = 0;
+            mask = 0;
+            value = 0;
+        }
+    }
+    if (mask) {
+        *p = (*p & ~mask) | value;
+    }
+}
+
+void epd_paint_draw_bitmap_file(epd_paint_t *epd_paint, int x, int y, int width, int height, FILE *file,
+                                dither_mode_t dither_mode, int colored) {
+    if (y + height < 0 || y >= epd_paint->rotated_height || x >= epd_paint->rotated_width || x + width < 0) {
+        return;
+    }
+
+    // image is read by bands of rows and dithered row by row, heap is band buffer plus error rows of dither
+    bmp_band_reader_t reader;
+    enum bmp_error err = bmp_band_reader_init(&reader, file, BMP_BAND_MAX_BYTES);
     if (err != BMP_OK) {
+        ESP_LOGW(TAG, "not valid bmp file %d", err);
         // not valid bmp pic just draw rec
         epd_paint_draw_rectangle(epd_paint, x, y, x + width - 1, y + height - 1, colored);
         epd_paint_draw_line(epd_paint, x, y, x + width, y + height, colored);
         epd_paint_draw_line(epd_paint, x, y + height, x + width, y, colored);
-    } else {
-        pixel_color out_color;
+        bmp_band_reader_free(&reader);
+        return;
+    }
 
-        uint16_t end_x = min(x + width, epd_paint->width);
-        end_x = min(end_x, bmp_header.img_header.biWidth);
+    int start_x = max(x, 0);
+    int end_x = min(min(x + width, x + reader.img.img_header.biWidth), epd_paint->rotated_width);
+    int start_y = max(y, 0);
+    int end_y = min(min(y + height, y + abs(reader.img.img_header.biHeight)), epd_paint->rotated_height);
+    int draw_width = end_x - start_x;
+    if (draw_width <= 0 || end_y <= start_y) {
+        bmp_band_reader_free(&reader);
+        return;
+    }
 
-        uint16_t end_y = min(y + height, epd_paint->height);
-        end_y = min(end_y, abs(bmp_header.img_header.biWidth));
+    if (epd_paint->rotate == ROTATE_0 && reader.black_white) {
+        // already black and white, no dither
+        bool invert = (reader.one_is_white != (colored != 0)) != (IF_INVERT_COLOR != 0);
+        for (int j = start_y; j < end_y; j++) {
+            const uint8_t *line = bmp_band_reader_get_line(&reader, j - y, file);
+            if (line == NULL) {
+                ESP_LOGW(TAG, "bmp read line error y:%d", j - y);
+                break;
+            }
+            copy_bits_row(epd_paint, start_x, j, line, start_x - x, draw_width, invert);
+        }
+        bmp_band_reader_free(&reader);
+        return;
+    }
 
-        bool error = false;
-        uint8_t *gray_color_data = (uint8_t *) malloc((end_y - y) * (end_x - x));
-        for (int j = y; j < end_y; ++j) {
-            for (int i = x; i < end_x; ++i) {
-                if (!error) {
-                    enum bmp_error pixel_error = bmp_file_get_pixel(&out_color, &bmp_header, (i - x), (j - y), file);
-                    if (pixel_error != BMP_OK) {
-                        error = true;
-                    }
-                }
-                if (error) {
-                    fill_err_color(&out_color, (i - x), (j - y));
-                }
-                gray_color_data[(j - y) * (end_x - x) + (i - x)] = bgr_to_gray(out_color);
+    dither_t dither;
+    uint8_t *gray = malloc(draw_width);
+    if (gray == NULL || !dither_init(&dither, dither_mode, draw_width)) {
+        ESP_LOGE(TAG, "no memory for bmp rows, width:%d", draw_width);
+        free(gray);
+        bmp_band_reader_free(&reader);
+        return;
+    }
+
+    bool error = false;
+    for (int j = start_y; j < end_y; j++) {
+        const uint8_t *line = NULL;
+        if (!error) {
+            line = bmp_band_reader_get_line(&reader, j - y, file);
+            if (line == NULL) {
+                ESP_LOGW(TAG, "bmp read line error y:%d", j - y);
+                error = true;
+            }
+        }
+        if (line != NULL) {
+            bmp_band_reader_line_to_gray(&reader, line, start_x - x, draw_width, gray);
+        } else {
+            pixel_color out_color;
+            for (int i = 0; i < draw_width; i++) {
+                fill_err_color(&out_color, start_x - x + i, j - y);
+                gray[i] = out_color.red;
+            }
+        }
+        if (!colored) {
+            for (int i = 0; i < draw_width; i++) {
+                gray[i] = 255 - gray[i];
             }
         }
 
-        dither(gray_color_data, end_x - x, end_y - y);
-        draw_gray_color(epd_paint, x, y, end_x, end_y, gray_color_data, colored);
-        free(gray_color_data);
+        dither_row(&dither, gray, start_x, j);
+        write_dithered_row(epd_paint, start_x, j, gray, draw_width);
     }
 
-    bmp_file_free(&bmp_header);
+    free(gray);
+    dither_deinit(&dither);
+    bmp_band_reader_free(&reader);
 }
 
-void
-epd_paint_draw_jpg_file(epd_paint_t *epd_paint, int x, int y, int width, int height, FILE *file, uint16_t file_size,
-                        int colored) {
-    jpg_t jpg_header;
-    enum jpg_err err = jpg_header_read_file(&jpg_header, file);
-    if (err != JPG_OK) {
-        // not valid bmp pic just draw rec
+/**
+ * draw width bits of an epi row at y, bit 1 is white. ROTATE_0 copies bytes,
+ * other rotations fill runs of one color by spans.
+ */
+static void draw_epi_row(epd_paint_t *epd_paint, int x, int y, const uint8_t *bits, int width, int colored) {
+    int start_x = max(x, 0);
+    int end_x = min(x + width, epd_paint->rotated_width);
+    if (y < 0 || y >= epd_paint->rotated_height || start_x >= end_x) {
+        return;
+    }
+    if (epd_paint->rotate == ROTATE_0) {
+        bool invert = (colored == 0) != (IF_INVERT_COLOR != 0);
+        copy_bits_row(epd_paint, start_x, y, bits, start_x - x, end_x - start_x, invert);
+        return;
+    }
+
+    span_op_t white_op = color_span_op(!colored);
+    span_op_t black_op = color_span_op(colored);
+    int run_start = start_x;
+    bool run_white = bits[(start_x - x) >> 3] & (0x80 >> ((start_x - x) & 7));
+    for (int i = start_x + 1; i <= end_x; i++) {
+        bool white = i < end_x && (bits[(i - x) >> 3] & (0x80 >> ((i - x) & 7)));
+        if (i == end_x || white != run_white) {
+            epd_paint_fill_span(epd_paint, run_start, y, i, y + 1, run_white ? white_op : black_op);
+            run_start = i;
+            run_white = white;
+        }
+    }
+}
+
+void epd_paint_draw_epi(epd_paint_t *epd_paint, int x, int y, int width, int height, const uint8_t *data,
+                        uint32_t data_size, int colored) {
+    if (y + height < 0 || y >= epd_paint->rotated_height || x >= epd_paint->rotated_width || x + width < 0) {
+        return;
+    }
+
+    epi_header_t header;
+    enum epi_err err = epi_header_read(&header, data, data_size);
+    if (err != EPI_OK) {
+        ESP_LOGW(TAG, "not valid epi image %d size:%ld", err, (long) data_size);
+        // not valid pic just draw rec
+        epd_paint_draw_rectangle(epd_paint, x, y, x + width, y + height, colored);
+        epd_paint_draw_line(epd_paint, x, y, x + width, y + height, colored);
+        epd_paint_draw_line(epd_paint, x, y + height, x + width, y, colored);
+        return;
+    }
+
+    // drawn in its own size like epd_paint_draw_bitmap, some icons are wider than the box given
+    int draw_width = header.width;
+    int end_y = min(y + header.height, epd_paint->rotated_height);
+    uint16_t row_bytes = epi_row_bytes(&header);
+    const uint8_t *src = data + sizeof(epi_header_t);
+    uint32_t remain = data_size - sizeof(epi_header_t);
+    uint8_t row[EPI_MAX_ROW_BYTES];
+    for (int j = y; j < end_y; j++) {
+        // plain rows are drawn from data as they are
+        const uint8_t *line = src;
+        uint32_t used = row_bytes <= remain ? row_bytes : 0;
+        if (header.flags & EPI_FLAG_PACKBITS) {
+            line = row;
+            used = epi_unpack_row(&header, src, remain, row);
+        }
+        if (used == 0) {
+            ESP_LOGW(TAG, "epi data short at row %d", j - y);
+            break;
+        }
+        src += used;
+        remain -= used;
+        draw_epi_row(epd_paint, x, j, line, draw_width, colored);
+    }
+}
+
+void epd_paint_draw_epi_file(epd_paint_t *epd_paint, int x, int y, int width, int height, FILE *file,
+                             int colored) {
+    if (y + height < 0 || y >= epd_paint->rotated_height || x >= epd_paint->rotated_width || x + width < 0) {
+        return;
+    }
+
+    epi_file_reader_t reader;
+    enum epi_err err = epi_file_reader_init(&reader, file);
+    if (err != EPI_OK) {
+        ESP_LOGW(TAG, "not valid epi file %d", err);
         epd_paint_draw_rectangle(epd_paint, x, y, x + width - 1, y + height - 1, colored);
         epd_paint_draw_line(epd_paint, x, y, x + width, y + height, colored);
         epd_paint_draw_line(epd_paint, x, y + height, x + width, y, colored);
-    } else {
-        uint16_t end_x = min(x + width, epd_paint->width);
-        end_x = min(end_x, jpg_header.width);
+        return;
+    }
 
-        uint16_t end_y = min(y + height, epd_paint->height);
-        end_y = min(end_y, jpg_header.height);
+    int draw_width = min(width, reader.header.width);
+    int end_y = min(y + min(height, reader.header.height), epd_paint->rotated_height);
+    for (int j = y; j < end_y; j++) {
+        const uint8_t *line = epi_file_reader_next_row(&reader, file);
+        if (line == NULL) {
+            ESP_LOGW(TAG, "epi read line error y:%d", j - y);
+            break;
+        }
+        draw_epi_row(epd_paint, x, j, line, draw_width, colored);
+    }
+}
 
-        jpg_header.pixel = NULL;
+void epd_paint_draw_icon(epd_paint_t *epd_paint, enum icon_id id, int x, int y, int colored) {
+    if ((unsigned) id >= ICON_COUNT) {
+        return;
+    }
+    const icon_t *icon = &icon_atlas[id][epd_paint->rotate & 3];
+    int w = epd_paint->width;
+    int h = epd_paint->height;
+    // top left of the turned icon in frame buffer, min is first column / row the rotation can reach
+    int abs_x = x;
+    int abs_y = y;
+    int min_x = 0;
+    int min_y = 0;
+    switch (epd_paint->rotate) {
+        case ROTATE_90:
+            // x' = width - y, y' = x
+            abs_x = w - y - icon->width + 1;
+            abs_y = x;
+            min_x = 1;
+            break;
+        case ROTATE_180:
+            // x' = width - x, y' = height - y
+            abs_x = w - x - icon->width + 1;
+            abs_y = h - y - icon->height + 1;
+            min_x = 1;
+            min_y = 1;
+            break;
+        case ROTATE_270:
+            // x' = y, y' = height - x
+            abs_x = y;
+            abs_y = h - x - icon->height + 1;
+            min_y = 1;
+            break;
+        default:
+            break;
+    }
 
-        int i, j;
-        pixel_color out_color;
-        bool error = false;
-        uint8_t *gray_color_data = (uint8_t *) malloc((end_y - y) * (end_x - x));
-
-        for (j = y; j < end_y; ++j) {
-            for (i = x; i < end_x; ++i) {
-                if (!error) {
-                    enum jpg_err get_pixel_err = jpg_file_get_pixel(&out_color, &jpg_header, (i - x), (j - y), file,
-                                                                    file_size);
-                    if (get_pixel_err != JPG_OK) {
-                        ESP_LOGW(TAG, "jpg get pixel error occurs x:%d y:%d", (i - x), (j - y));
-                        error = true;
-                    }
-                }
-                if (error) {
-                    fill_err_color(&out_color, (i - x), (j - y));
-                }
-                gray_color_data[(j - y) * (end_x - x) + (i - x)] = bgr_to_gray(out_color);
-            }
+    int start_x = max(abs_x, min_x);
+    int end_x = min(abs_x + icon->width, w);
+    int start_y = max(abs_y, min_y);
+    int end_y = min(abs_y + icon->height, h);
+    if (start_x >= end_x) {
+        return;
+    }
+    uint16_t row_bytes = (icon->width + 7) >> 3;
+    const uint8_t *rows = icon_atlas_data + icon->offset;
+    bool invert = (colored == 0) != (IF_INVERT_COLOR != 0);
+    for (int j = start_y; j < end_y; j++) {
+        copy_bits_row(epd_paint, start_x, j, rows + (j - abs_y) * row_bytes, start_x - abs_x, end_x - start_x,
+                      invert);
+    }
+}
+
+typedef struct {
+    epd_paint_t *epd_paint;
+    int x;
+    int y;
+    int start_x;
+    int end_x;
+    int end_y;
+    int colored;
+    dither_mode_t dither_mode;
+    dither_t dither;
+    bool dither_ready;
+} jpg_draw_t;
+
+static bool draw_jpg_row(void *ctx, uint16_t row, uint8_t *gray, uint16_t width) {
+    jpg_draw_t *draw = (jpg_draw_t *) ctx;
+    int j = draw->y + row;
+    if (j >= draw->end_y) {
+        return false;
+    }
+    int draw_width = min(draw->end_x, draw->x + width) - draw->start_x;
+    if (j < 0 || draw_width <= 0) {
+        return true;
+    }
+    if (!draw->dither_ready) {
+        // error rows follow first row width, all rows have same width
+        if (!dither_init(&draw->dither, draw->dither_mode, draw_width)) {
+            ESP_LOGE(TAG, "no memory for jpg dither, width:%d", draw_width);
+            return false;
         }
+        draw->dither_ready = true;
+    }
 
-        dither(gray_color_data, end_x - x, end_y - y);
-        draw_gray_color(epd_paint, x, y, end_x, end_y, gray_color_data, colored);
-        free(gray_color_data);
+    gray += draw->start_x - draw->x;
+    if (!draw->colored) {
+        for (int i = 0; i < draw_width; i++) {
+            gray[i] = 255 - gray[i];
+        }
+    }
+    dither_row(&draw->dither, gray, draw->start_x, j);
+    write_dithered_row(draw->epd_paint, draw->start_x, j, gray, draw_width);
+    return true;
+}
 
-        jpg_file_free(&jpg_header);
+void epd_paint_draw_jpg_file(epd_paint_t *epd_paint, int x, int y, int width, int height, FILE *file,
+                             dither_mode_t dither_mode, int colored) {
+    if (y + height < 0 || y >= epd_paint->rotated_height || x >= epd_paint->rotated_width || x + width < 0) {
+        return;
     }
 
+    // decoded by mcu rows and dithered row by row, no full image buffer
+    jpg_draw_t draw = {
+            .epd_paint = epd_paint,
+            .x = x,
+            .y = y,
+            .start_x = max(x, 0),
+            .end_x = min(x + width, epd_paint->rotated_width),
+            .end_y = min(y + height, epd_paint->rotated_height),
+            .colored = colored,
+            .dither_mode = dither_mode,
+    };
+    enum jpg_err err = jpg_file_decode_gray(file, width, height, draw_jpg_row, &draw);
+    if (draw.dither_ready) {
+        dither_deinit(&draw.dither);
+    }
+    if (err != JPG_OK && !draw.dither_ready) {
+        ESP_LOGW(TAG, "not valid jpg file %d", err);
+        // not valid jpg pic just draw rec
+        epd_paint_draw_rectangle(epd_paint, x, y, x + width - 1, y + height - 1, colored);
+        epd_paint_draw_line(epd_paint, x, y, x + width, y + height, colored);
+        epd_paint_draw_line(epd_paint, x, y + height, x + width, y, colored);
+    }
 }
 
 /* END OF FILE */
@@ -11,14 +11,36 @@
 #define IF_INVERT_COLOR     0
 
 #include <stdio.h>
+#include <stdbool.h>
 #include "fonts.h"
+#include "dither.h"
+#include "icon.h"
 
-typedef struct {
+typedef struct epd_paint epd_paint_t;
+
+typedef void (*epd_paint_draw_pixel_fn)(epd_paint_t *epd_paint, int x, int y, int colored);
+
+typedef uint8_t (*epd_paint_get_pixel_fn)(epd_paint_t *epd_paint, int x, int y);
+
+struct epd_paint {
     unsigned char *image;
     int width;
     int height;
     int rotate;
-} epd_paint_t;
+
+    // rebuilt by epd_paint_init / epd_paint_set_rotation, never set them directly
+    int stride; // bytes per absolute row
+    int rotated_width; // width after rotate
+    int rotated_height; // height after rotate
+    epd_paint_draw_pixel_fn draw_pixel;
+    epd_paint_get_pixel_fn get_pixel;
+
+    // absolute area changed by drawing since last epd_paint_reset_dirty, empty if dirty_x >= dirty_end_x
+    int dirty_x;
+    int dirty_y;
+    int dirty_end_x;
+    int dirty_end_y;
+};
 
 typedef struct {
     uint8_t blue;
@@ -38,6 +60,16 @@ void epd_paint_set_rotation(epd_paint_t *epd_paint, uint8_t rotate);
 
 void epd_paint_deinit(epd_paint_t *epd_paint);
 
+void epd_paint_reset_dirty(epd_paint_t *epd_paint);
+
+void epd_paint_mark_dirty(epd_paint_t *epd_paint, int x, int y, int end_x, int end_y);
+
+/**
+ * get absolute area drawn since last reset, x and end_x are aligned to byte, end is not included.
+ * return false if nothing drawn
+ */
+bool epd_paint_get_dirty_area(epd_paint_t *epd_paint, int *x, int *y, int *end_x, int *end_y);
+
 void epd_paint_clear(epd_paint_t *epd_paint, int colored);
 
 void epd_paint_clear_range(epd_paint_t *epd_paint, int start_x, int start_y, int width, int height, int colored);
@@ -46,6 +78,8 @@ void epd_paint_reverse_range(epd_paint_t *epd_paint, int start_x, int start_y, i
 
 void epd_paint_draw_pixel(epd_paint_t *epd_paint, int x, int y, int colored);
 
+uint8_t epd_paint_get_pixel(epd_paint_t *epd_paint, int x, int y);
+
 uint8_t epd_paint_draw_string_at(epd_paint_t *epd_paint, int x, int y, const char *text, sFONT *font, int colored);
 
 uint8_t epd_paint_draw_string_at_position(epd_paint_t *epd_paint, int x, int y, int endx, int endy,
@@ -82,14 +116,29 @@ void epd_paint_draw_filled_circle(epd_paint_t *epd_paint, int x, int y, int radi
 void epd_paint_draw_bitmap(epd_paint_t *epd_paint, int x, int y, int width, int height, uint8_t *bmp_data,
                            uint16_t data_size, int colored);
 
-void epd_paint_draw_bitmap_file(epd_paint_t *epd_paint, int x, int y, int width, int height, FILE *file, int colored);
+void epd_paint_draw_bitmap_file(epd_paint_t *epd_paint, int x, int y, int width, int height, FILE *file,
+                                dither_mode_t dither_mode, int colored);
 
 void epd_paint_draw_bitmap_file_with_align(epd_paint_t *epd_paint, int x, int y, int width, int height,
                                            FILE *file, int colored,
                                            int halign, int valign);
 
-void
-epd_paint_draw_jpg_file(epd_paint_t *epd_paint, int x, int y, int width, int height, FILE *file, uint16_t file_size,
-                        int colored);
+void epd_paint_draw_jpg_file(epd_paint_t *epd_paint, int x, int y, int width, int height, FILE *file,
+                             dither_mode_t dither_mode, int colored);
+
+/**
+ * draw native 1 bit image of lcd/epi.h in its own size like epd_paint_draw_bitmap,
+ * width and height are the box drawn when data is not valid
+ */
+void epd_paint_draw_epi(epd_paint_t *epd_paint, int x, int y, int width, int height, const uint8_t *data,
+                        uint32_t data_size, int colored);
+
+void epd_paint_draw_epi_file(epd_paint_t *epd_paint, int x, int y, int width, int height, FILE *file,
+                             int colored);
+
+/**
+ * draw icon of lcd/icon.h atlas, the variant turned for current rotation is copied by byte rows
+ */
+void epd_paint_draw_icon(epd_paint_t *epd_paint, enum icon_id id, int x, int y, int colored);
 
 #endif
\ No newline at end of file
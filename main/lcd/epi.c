@@ -0,0 +1,98 @@
+#include "epi.h"
+
+#include <string.h>
+#include "esp_log.h"
+
+#define TAG "epi"
+
+enum epi_err epi_header_read(epi_header_t *header, const uint8_t *data, uint32_t data_len) {
+    if (data == NULL || data_len < sizeof(epi_header_t)) {
+        return EPI_INVALID_FILE;
+    }
+    memcpy(header, data, sizeof(epi_header_t));
+    if (header->magic != EPI_MAGIC || header->width == 0 || header->height == 0) {
+        return EPI_INVALID_FILE;
+    }
+    if ((header->flags & ~EPI_FLAG_PACKBITS) || epi_row_bytes(header) > EPI_MAX_ROW_BYTES) {
+        return EPI_NOT_SUPPORTED_FORMAT;
+    }
+    return EPI_OK;
+}
+
+uint16_t epi_row_bytes(const epi_header_t *header) {
+    return (header->width + 7) >> 3;
+}
+
+uint32_t epi_unpack_row(const epi_header_t *header, const uint8_t *src, uint32_t src_len, uint8_t *row) {
+    uint16_t row_bytes = epi_row_bytes(header);
+    if (!(header->flags & EPI_FLAG_PACKBITS)) {
+        if (src_len < row_bytes) {
+            return 0;
+        }
+        memcpy(row, src, row_bytes);
+        return row_bytes;
+    }
+
+    uint32_t pos = 0;
+    uint16_t out = 0;
+    while (out < row_bytes) {
+        if (pos >= src_len) {
+            return 0;
+        }
+        int8_t n = (int8_t) src[pos++];
+        if (n >= 0) {
+            uint16_t count = n + 1;
+            if (pos + count > src_len || out + count > row_bytes) {
+                return 0;
+            }
+            memcpy(row + out, src + pos, count);
+            pos += count;
+            out += count;
+        } else if (n != -128) {
+            uint16_t count = 1 - n;
+            if (pos >= src_len || out + count > row_bytes) {
+                return 0;
+            }
+            memset(row + out, src[pos++], count);
+            out += count;
+        }
+    }
+    return pos;
+}
+
+enum epi_err epi_file_reader_init(epi_file_reader_t *reader, FILE *img_file) {
+    if (img_file == NULL) {
+        return EPI_INVALID_FILE;
+    }
+    uint8_t buff[sizeof(epi_header_t)];
+    if (fread(buff, sizeof(buff), 1, img_file) != 1) {
+        return EPI_INVALID_FILE;
+    }
+    enum epi_err err = epi_header_read(&reader->header, buff, sizeof(buff));
+    if (err != EPI_OK) {
+        return err;
+    }
+    reader->row_bytes = epi_row_bytes(&reader->header);
+    reader->buff_pos = 0;
+    reader->buff_len = 0;
+    return EPI_OK;
+}
+
+const uint8_t *epi_file_reader_next_row(epi_file_reader_t *reader, FILE *img_file) {
+    // keep a whole packed row in buffer
+    if (reader->buff_len - reader->buff_pos < EPI_MAX_PACKED_ROW_BYTES) {
+        uint16_t remain = reader->buff_len - reader->buff_pos;
+        memmove(reader->buff, reader->buff + reader->buff_pos, remain);
+        reader->buff_len = remain + fread(reader->buff + remain, 1, EPI_FILE_BUFF_SIZE - remain, img_file);
+        reader->buff_pos = 0;
+    }
+
+    uint32_t used = epi_unpack_row(&reader->header, reader->buff + reader->buff_pos,
+                                   reader->buff_len - reader->buff_pos, reader->row);
+    if (used == 0) {
+        ESP_LOGW(TAG, "broken row, %d bytes left in buffer", reader->buff_len - reader->buff_pos);
+        return NULL;
+    }
+    reader->buff_pos += used;
+    return reader->row;
+}
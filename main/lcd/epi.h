@@ -0,0 +1,72 @@
+#ifndef EPI_H
+#define EPI_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/**
+ * epi, native 1 bit image of the panel. made from bmp by main/tools/bmp_to_epi.py,
+ * rows are frame buffer bits so drawing is a byte copy, no header checks or palette lookup per pixel.
+ *
+ * little endian 12 bytes header, then height rows top down.
+ * a row is (width + 7) / 8 bytes, msb first, bit 1 is white.
+ * with EPI_FLAG_PACKBITS every row is packbits on its own:
+ * n 0..127 copy next n + 1 bytes, n -1..-127 repeat next byte 1 - n times, -128 skipped.
+ */
+
+#define EPI_MAGIC 0x31495045 // "EPI1"
+
+#define EPI_FLAG_PACKBITS (1 << 0)
+
+// 512 pixels, rows are unpacked into buffer of this size
+#define EPI_MAX_ROW_BYTES 64
+
+// packbits of a row is at most one count byte more every 128 bytes
+#define EPI_MAX_PACKED_ROW_BYTES (EPI_MAX_ROW_BYTES + (EPI_MAX_ROW_BYTES + 127) / 128)
+
+#define EPI_FILE_BUFF_SIZE 256
+
+enum epi_err {
+    EPI_NOT_SUPPORTED_FORMAT = -3,
+    EPI_INVALID_FILE,
+    EPI_ERROR,
+    EPI_OK = 0
+};
+
+typedef struct {
+    uint32_t magic;
+    uint16_t width;
+    uint16_t height;
+    uint8_t flags;
+    uint8_t reserved[3];
+} __attribute__((packed)) epi_header_t;
+
+/**
+ * reads rows of a file in order through a small buffer
+ */
+typedef struct {
+    epi_header_t header;
+    uint16_t row_bytes;
+    uint16_t buff_pos;
+    uint16_t buff_len;
+    uint8_t buff[EPI_FILE_BUFF_SIZE];
+    uint8_t row[EPI_MAX_ROW_BYTES];
+} epi_file_reader_t;
+
+enum epi_err epi_header_read(epi_header_t *header, const uint8_t *data, uint32_t data_len);
+
+uint16_t epi_row_bytes(const epi_header_t *header);
+
+/**
+ * unpack one row from src into row, returns bytes of src used, 0 if src is broken or short
+ */
+uint32_t epi_unpack_row(const epi_header_t *header, const uint8_t *src, uint32_t src_len, uint8_t *row);
+
+enum epi_err epi_file_reader_init(epi_file_reader_t *reader, FILE *img_file);
+
+/**
+ * next row of file, NULL on read error or broken data
+ */
+const uint8_t *epi_file_reader_next_row(epi_file_reader_t *reader, FILE *img_file);
+
+#endif
@@ -0,0 +1,133 @@
+#include <string.h>
+
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+
+#include "gui_trace.h"
+
+// kept over deep sleep, frames before sleep can still be read after wake up
+RTC_DATA_ATTR static gui_trace_frame_t frames[GUI_TRACE_FRAME_COUNT];
+// next slot to write
+RTC_DATA_ATTR static uint8_t frame_head = 0;
+RTC_DATA_ATTR static uint8_t frame_count = 0;
+
+static gui_trace_frame_t *current_frame = NULL;
+// frame whose refresh is running, busy isr finishes it
+static gui_trace_frame_t *busy_frame = NULL;
+
+// key and notify come before the frame they wake up
+static uint8_t pending_mask = 0;
+static int64_t pending_us[GUI_TRACE_NOTIFY + 1];
+
+static portMUX_TYPE trace_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static void mark_pending(gui_trace_stage_t stage) {
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&trace_lock);
+    if (!(pending_mask & (1 << stage))) {
+        pending_mask |= 1 << stage;
+        pending_us[stage] = now;
+    }
+    portEXIT_CRITICAL(&trace_lock);
+}
+
+void gui_trace_key_event() {
+    mark_pending(GUI_TRACE_KEY);
+}
+
+void gui_trace_notify() {
+    mark_pending(GUI_TRACE_NOTIFY);
+}
+
+void gui_trace_frame_begin(uint32_t boot_cnt, uint32_t loop_cnt, epd_update_request_t request) {
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&trace_lock);
+    gui_trace_frame_t *frame = &frames[frame_head];
+    if (busy_frame == frame) {
+        // ring wrapped before refresh done
+        busy_frame = NULL;
+    }
+    frame_head = (frame_head + 1) % GUI_TRACE_FRAME_COUNT;
+    if (frame_count < GUI_TRACE_FRAME_COUNT) {
+        frame_count++;
+    }
+
+    frame->loop_cnt = loop_cnt;
+    frame->boot_cnt = boot_cnt;
+    frame->request = request;
+    frame->flags = 0;
+    frame->wake_us = now;
+    for (uint8_t i = 0; i < GUI_TRACE_STAGE_COUNT; i++) {
+        frame->stage_us[i] = GUI_TRACE_NOT_SET;
+    }
+    for (uint8_t i = GUI_TRACE_KEY; i <= GUI_TRACE_NOTIFY; i++) {
+        if (pending_mask & (1 << i)) {
+            frame->stage_us[i] = (int32_t) (pending_us[i] - now);
+        }
+    }
+    pending_mask = 0;
+    current_frame = frame;
+    portEXIT_CRITICAL(&trace_lock);
+}
+
+void gui_trace_stage(gui_trace_stage_t stage) {
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&trace_lock);
+    if (current_frame != NULL) {
+        current_frame->stage_us[stage] = (int32_t) (now - current_frame->wake_us);
+        if (stage == GUI_TRACE_REFRESH_START) {
+            busy_frame = current_frame;
+        }
+    }
+    portEXIT_CRITICAL(&trace_lock);
+}
+
+void gui_trace_set_flags(uint8_t flags) {
+    portENTER_CRITICAL(&trace_lock);
+    if (current_frame != NULL) {
+        current_frame->flags |= flags;
+    }
+    portEXIT_CRITICAL(&trace_lock);
+}
+
+void IRAM_ATTR gui_trace_busy_done_isr(void *arg) {
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL_ISR(&trace_lock);
+    if (busy_frame != NULL) {
+        busy_frame->stage_us[GUI_TRACE_BUSY_RELEASE] = (int32_t) (now - busy_frame->wake_us);
+        busy_frame = NULL;
+    }
+    portEXIT_CRITICAL_ISR(&trace_lock);
+}
+
+uint8_t gui_trace_get_frames(gui_trace_frame_t *out, uint8_t max_count) {
+    portENTER_CRITICAL(&trace_lock);
+    uint8_t count = frame_count < max_count ? frame_count : max_count;
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t index = (frame_head + GUI_TRACE_FRAME_COUNT - 1 - i) % GUI_TRACE_FRAME_COUNT;
+        out[i] = frames[index];
+    }
+    portEXIT_CRITICAL(&trace_lock);
+    return count;
+}
+
+static uint8_t *put_le32(uint8_t *out, uint32_t value) {
+    out[0] = value;
+    out[1] = value >> 8;
+    out[2] = value >> 16;
+    out[3] = value >> 24;
+    return out + 4;
+}
+
+uint8_t gui_trace_pack_frame(const gui_trace_frame_t *frame, uint8_t *out) {
+    uint8_t *p = put_le32(out, frame->loop_cnt);
+    *p++ = frame->boot_cnt;
+    *p++ = frame->boot_cnt >> 8;
+    *p++ = frame->request;
+    *p++ = frame->flags;
+    for (uint8_t i = 0; i < GUI_TRACE_STAGE_COUNT; i++) {
+        p = put_le32(p, (uint32_t) frame->stage_us[i]);
+    }
+    return p - out;
+}
@@ -0,0 +1,70 @@
+#ifndef GUI_TRACE_H
+#define GUI_TRACE_H
+
+#include <stdint.h>
+#include "epd_refresh_scheduler.h"
+
+/**
+ * per frame timestamps of gui loop, to find where key to pixel latency comes from.
+ * last frames are kept in a ring buffer, read by debug page and ble.
+ */
+
+#define GUI_TRACE_FRAME_COUNT 12
+
+// stage not reached in this frame
+#define GUI_TRACE_NOT_SET INT32_MIN
+
+#define GUI_TRACE_FLAG_FULL_REFRESH (1 << 0)
+// frame not changed, no refresh
+#define GUI_TRACE_FLAG_SKIPPED (1 << 1)
+// drawn again for request come in while panel busy
+#define GUI_TRACE_FLAG_REDRAW (1 << 2)
+
+// us relative to gui task wake up, key and notify are before it so negative
+typedef enum {
+    GUI_TRACE_KEY = 0, // first key event since last frame
+    GUI_TRACE_NOTIFY, // first update request since last frame
+    GUI_TRACE_DRAW_START, // panel init done
+    GUI_TRACE_DRAW_DONE,
+    GUI_TRACE_UPLOAD_DONE, // frame queued to spi
+    GUI_TRACE_AFTER_DRAW_DONE,
+    GUI_TRACE_REFRESH_START, // refresh command sent, includes wait for last refresh
+    GUI_TRACE_BUSY_RELEASE, // refresh done, pixels on screen
+    GUI_TRACE_STAGE_COUNT,
+} gui_trace_stage_t;
+
+typedef struct {
+    uint32_t loop_cnt;
+    uint16_t boot_cnt;
+    uint8_t request; // epd_update_request_t
+    uint8_t flags;
+    int64_t wake_us; // esp_timer_get_time, restarts every boot
+    int32_t stage_us[GUI_TRACE_STAGE_COUNT];
+} gui_trace_frame_t;
+
+// little endian loop_cnt u32, boot_cnt u16, request u8, flags u8, stage_us i32 * GUI_TRACE_STAGE_COUNT
+#define GUI_TRACE_PACKED_FRAME_SIZE (8 + 4 * GUI_TRACE_STAGE_COUNT)
+
+void gui_trace_key_event();
+
+void gui_trace_notify();
+
+void gui_trace_frame_begin(uint32_t boot_cnt, uint32_t loop_cnt, epd_update_request_t request);
+
+void gui_trace_stage(gui_trace_stage_t stage);
+
+void gui_trace_set_flags(uint8_t flags);
+
+/**
+ * epd_panel_busy_done_cb_t, set busy release of frame whose refresh started
+ */
+void gui_trace_busy_done_isr(void *arg);
+
+/**
+ * copy at most max_count frames, newest first
+ */
+uint8_t gui_trace_get_frames(gui_trace_frame_t *frames, uint8_t max_count);
+
+uint8_t gui_trace_pack_frame(const gui_trace_frame_t *frame, uint8_t *out);
+
+#endif
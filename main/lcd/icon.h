@@ -0,0 +1,23 @@
+#ifndef ICON_H
+#define ICON_H
+
+#include <stdint.h>
+// enum icon_id, made by tools/icon_atlas.py from static/icons.txt
+#include "icon_id.h"
+
+/**
+ * one rotation of an icon in icon_atlas_data, already turned to frame buffer layout.
+ * height rows of (width + 7) / 8 bytes at offset, msb first, bit 1 is white.
+ */
+typedef struct {
+    uint16_t width;
+    uint16_t height;
+    uint32_t offset;
+} icon_t;
+
+// indexed by icon id and epd_paint rotate
+extern const icon_t icon_atlas[ICON_COUNT][4];
+
+extern const uint8_t icon_atlas_data[];
+
+#endif
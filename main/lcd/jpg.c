@@ -4,11 +4,28 @@
 #include <dirent.h>
 #include<sys/stat.h>
 
-#include "jpeg_decoder.h"
+#include "tjpgd.h"
 #include "jpg.h"
+#include "common_utils.h"
 
 #define TAG "jpg"
 
+// tjpgd work area, same size esp_jpeg gives it
+#define JPG_WORK_BUF_SIZE 3100
+
+typedef struct {
+    FILE *file;
+    uint8_t *band; // gray of one mcu row
+    uint16_t band_width;
+    uint16_t band_height;
+    uint16_t band_top; // output y of first band row
+    uint16_t band_rows; // rows of band with data
+    uint16_t max_height;
+    jpg_gray_row_cb row_cb;
+    void *ctx;
+    bool stop; // row_cb asked to stop or rows after max_height
+} jpg_stream_t;
+
 enum jpg_err jpg_header_read(jpg_t *header, uint8_t *data, uint16_t data_len) {
     uint16_t magic = ((uint16_t *) data)[0];
     if (magic != JPG_MAGIC) {
@@ -91,66 +108,120 @@ enum jpg_err jpg_header_read_file(jpg_t *header, FILE *img_file) {
     return JPG_ERROR;
 }
 
-enum jpg_err
-jpg_file_get_pixel(pixel_color *out_color, jpg_t *jpg_img, uint16_t x, uint16_t y, FILE *img_file, uint16_t file_size) {
-    if (jpg_img->pixel == NULL) {
-        //ESP_LOGI(TAG, "read jpg file to buff");
-        uint8_t *indata = calloc(file_size, sizeof(uint8_t));
-        if (indata == NULL) {
-            ESP_LOGE(TAG, "Error allocating memory for file");
-            return JPG_ERROR;
-        }
-        fseek(img_file, 0, SEEK_SET);
-        fread(indata, sizeof(uint8_t), file_size, img_file);
+static size_t jpg_stream_input(JDEC *jd, uint8_t *buff, size_t nbyte) {
+    jpg_stream_t *stream = (jpg_stream_t *) jd->device;
+    if (buff == NULL) {
+        // decoder skips data
+        return fseek(stream->file, nbyte, SEEK_CUR) == 0 ? nbyte : 0;
+    }
+    return fread(buff, 1, nbyte, stream->file);
+}
 
-        uint16_t *pixels = calloc(jpg_img->height * jpg_img->width, sizeof(uint16_t));
-        if (pixels == NULL) {
-            ESP_LOGE(TAG, "Error allocating memory for pixel");
+static bool jpg_stream_flush_band(jpg_stream_t *stream) {
+    for (uint16_t i = 0; i < stream->band_rows; i++) {
+        uint16_t y = stream->band_top + i;
+        if (y >= stream->max_height
+            || !stream->row_cb(stream->ctx, y, stream->band + i * stream->band_width, stream->band_width)) {
+            return false;
+        }
+    }
+    stream->band_rows = 0;
+    return true;
+}
 
-            free(indata);
-            return JPG_ERROR;
+/**
+ * mcu blocks come left to right then next mcu row, band is handed out when next mcu row starts
+ */
+static int jpg_stream_output(JDEC *jd, void *bitmap, JRECT *rect) {
+    jpg_stream_t *stream = (jpg_stream_t *) jd->device;
+    if (rect->top != stream->band_top) {
+        if (!jpg_stream_flush_band(stream) || rect->top >= stream->max_height) {
+            stream->stop = true;
+            return 0;
         }
+        stream->band_top = rect->top;
+    }
+
+    uint16_t rect_width = rect->right - rect->left + 1;
+    uint16_t rows = min(rect->bottom - rect->top + 1, stream->band_height);
+    stream->band_rows = max(stream->band_rows, rows);
+    if (rect->left >= stream->band_width) {
+        return 1;
+    }
 
-        // JPEG decode config
-        esp_jpeg_image_cfg_t jpeg_cfg = {
-                .indata = indata,
-                .indata_size = file_size,
-                .outbuf = (uint8_t *) pixels,
-                .outbuf_size = jpg_img->width * jpg_img->height * sizeof(uint16_t),
-                .out_format = JPEG_IMAGE_FORMAT_RGB565,
-                .out_scale = JPEG_IMAGE_SCALE_0,
-                .flags = {
-                        .swap_color_bytes = 1,
-                }
-        };
-
-        //JPEG decode
-        esp_jpeg_image_output_t outimg;
-        esp_err_t error = esp_jpeg_decode(&jpeg_cfg, &outimg);
-
-        free(indata);
-
-        if (error != ESP_OK) {
-            free(pixels);
-            return JPG_ERROR;
+    uint16_t width = min(rect_width, stream->band_width - rect->left);
+    for (uint16_t r = 0; r < rows; r++) {
+        uint8_t *gray = stream->band + r * stream->band_width + rect->left;
+#if JD_FORMAT == 0
+        const uint8_t *src = (const uint8_t *) bitmap + r * rect_width * 3;
+        for (uint16_t i = 0; i < width; i++, src += 3) {
+            gray[i] = (src[0] * 77 + src[1] * 151 + src[2] * 28) >> 8;
         }
+#else
+        const uint16_t *src = (const uint16_t *) bitmap + r * rect_width;
+        for (uint16_t i = 0; i < width; i++) {
+            uint8_t red = (src[i] >> 11) << 3, green = ((src[i] >> 5) & 0x3f) << 2, blue = (src[i] & 0x1f) << 3;
+            gray[i] = (red * 77 + green * 151 + blue * 28) >> 8;
+        }
+#endif
+    }
+    return 1;
+}
 
-        jpg_img->pixel = (uint8_t *) pixels;
-        ESP_LOGI(TAG, "JPEG image decoded! Size of the decoded image is: %dpx x %dpx", outimg.width, outimg.height);
+enum jpg_err jpg_file_decode_gray(FILE *img_file, uint16_t max_width, uint16_t max_height,
+                                  jpg_gray_row_cb row_cb, void *ctx) {
+    if (img_file == NULL) {
+        return JPG_INVALID_FILE;
     }
 
-    // JPEG_IMAGE_FORMAT_RGB565
-    uint16_t pixel = ((uint16_t *)jpg_img->pixel)[y * jpg_img->width + x];
-    out_color->blue = (pixel & 0b11111) << 3;
-    out_color->green = ((pixel >> 5) & 0b111111) << 2;
-    out_color->red = ((pixel >> 11) & 0b11111) << 3;
+    jpg_stream_t stream = {
+            .file = img_file,
+            .max_height = max_height,
+            .row_cb = row_cb,
+            .ctx = ctx,
+    };
+    void *work = malloc(JPG_WORK_BUF_SIZE);
+    if (work == NULL) {
+        ESP_LOGE(TAG, "no memory for jpg work area");
+        return JPG_ERROR;
+    }
 
-    return JPG_OK;
-}
+    JDEC jd;
+    fseek(img_file, 0, SEEK_SET);
+    JRESULT res = jd_prepare(&jd, jpg_stream_input, work, JPG_WORK_BUF_SIZE, &stream);
+    if (res != JDR_OK) {
+        ESP_LOGW(TAG, "jpg prepare failed %d", res);
+        free(work);
+        return res == JDR_FMT3 ? JPG_NOT_SUPPORTED_FORMAT : JPG_INVALID_FILE;
+    }
 
-void jpg_file_free(jpg_t *jpg_img) {
-    if (jpg_img->pixel != NULL) {
-        free(jpg_img->pixel);
-        jpg_img->pixel = NULL;
+    // least scale down which fits
+    uint8_t scale = 0;
+    while (scale < 3 && (((jd.width + (1 << scale) - 1) >> scale) > max_width
+                         || ((jd.height + (1 << scale) - 1) >> scale) > max_height)) {
+        scale++;
+    }
+    stream.band_width = min((jd.width + (1 << scale) - 1) >> scale, max_width);
+    stream.band_height = max((jd.msy * 8) >> scale, 1);
+    stream.band = malloc(stream.band_width * stream.band_height);
+    if (stream.band == NULL) {
+        ESP_LOGE(TAG, "no memory for jpg band %dx%d", stream.band_width, stream.band_height);
+        free(work);
+        return JPG_ERROR;
     }
-}
\ No newline at end of file
+    ESP_LOGI(TAG, "decode jpg %dx%d scale 1/%d band %dx%d", jd.width, jd.height, 1 << scale,
+             stream.band_width, stream.band_height);
+
+    res = jd_decomp(&jd, jpg_stream_output, scale);
+    if (res == JDR_OK) {
+        jpg_stream_flush_band(&stream);
+    }
+
+    free(stream.band);
+    free(work);
+    if (res != JDR_OK && !(res == JDR_INTR && stream.stop)) {
+        ESP_LOGW(TAG, "jpg decode failed %d", res);
+        return JPG_ERROR;
+    }
+    return JPG_OK;
+}
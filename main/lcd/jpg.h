@@ -18,15 +18,24 @@ enum jpg_err {
 typedef struct {
     uint16_t width;
     uint16_t height;
-    uint8_t *pixel;
 } jpg_t;
 
+/**
+ * one decoded row, top down. gray is only valid in the call and may be changed by it.
+ * return false to stop decode.
+ */
+typedef bool (*jpg_gray_row_cb)(void *ctx, uint16_t y, uint8_t *gray, uint16_t width);
+
 enum jpg_err jpg_header_read(jpg_t *header, uint8_t *data, uint16_t data_len);
 
 enum jpg_err jpg_header_read_file(jpg_t *header, FILE *img_file);
 
-enum jpg_err
-jpg_file_get_pixel(pixel_color *out_color, jpg_t *jpg_img, uint16_t x, uint16_t y, FILE *img_file, uint16_t file_size);
+/**
+ * decode file by mcu rows to gray, file is read in chunks while decoding.
+ * decoder scales down 1/2 1/4 1/8 till image fits max size, rows wider than max_width are cut.
+ * heap is decoder work area and one mcu row of gray.
+ */
+enum jpg_err jpg_file_decode_gray(FILE *img_file, uint16_t max_width, uint16_t max_height,
+                                  jpg_gray_row_cb row_cb, void *ctx);
 
-void jpg_file_free(jpg_t *jpg_img);
-#endif
\ No newline at end of file
+#endif
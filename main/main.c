@@ -26,6 +26,7 @@
 #include "sht40.h"
 #include "beep/beep.h"
 #include "spl06.h"
+#include "file/image_index.h"
 
 static const char *TAG = "BIKE_MAIN";
 #define I2C_MASTER_NUM              0
@@ -94,6 +95,11 @@ void app_main() {
      */
     battery_init();
 
+    /**
+     * image list, shared by gui and ble upload
+     */
+    image_index_init();
+
     /**
      * lcd
      */
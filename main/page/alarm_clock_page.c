@@ -46,7 +46,7 @@ static void date_time_event_handler(void *arg, esp_event_base_t event_base, int3
             number_input_view_set_value(hour_number_input_view, alarm.hour);
             number_input_view_set_value(minute_number_input_view, alarm.minute);
 
-            page_manager_request_update(false);
+            page_manager_request_update(EPD_UPDATE_NORMAL);
             break;
         }
         default:
@@ -79,7 +79,7 @@ static void on_save_btn_click(view_t *v) {
     ESP_LOGI(TAG, "save alarm en:%d, min:%d, hour:%d, dayweek:%d", alarm.en, alarm.minute, alarm.hour, alarm.day_week);
     if (err == ESP_OK) {
         page_manager_close_page();
-        page_manager_request_update(false);
+        page_manager_request_update(EPD_UPDATE_NORMAL);
     }
 }
 
@@ -209,7 +209,7 @@ bool alarm_clock_page_key_click(key_event_id_t key_event_type) {
         case KEY_OK_SHORT_CLICK:
             if (load_alarm_failed || alarm_not_support_day_mode) {
                 page_manager_close_page();
-                page_manager_request_update(false);
+                page_manager_request_update(EPD_UPDATE_NORMAL);
                 return true;
             }
             break;
@@ -222,7 +222,7 @@ bool alarm_clock_page_key_click(key_event_id_t key_event_type) {
                     .auto_close_ms = 5000
             };
             page_manager_show_menu("alert-dialog", &alert_dialog_arg);
-            page_manager_request_update(false);
+            page_manager_request_update(EPD_UPDATE_NORMAL);
             return true;
         }
             break;
@@ -22,7 +22,7 @@ static esp_timer_handle_t auto_close_timer_hdl = NULL;
 static void auto_close_timer_callback(void *arg) {
     ESP_LOGI(TAG, "auto close dialog alert dialog created");
     page_manager_close_menu();
-    page_manager_request_update(false);
+    page_manager_request_update(EPD_UPDATE_NORMAL);
 }
 
 void alert_dialog_page_on_create(void *arg) {
@@ -89,7 +89,7 @@ bool alert_dialog_page_key_click(key_event_id_t key_event_type) {
         dialog_arg->callback();
     }
     page_manager_close_menu();
-    page_manager_request_update(false);
+    page_manager_request_update(EPD_UPDATE_NORMAL);
     return true;
 }
 
@@ -20,7 +20,7 @@ static void confirm_start_curving_dialog_callback(bool confirm) {
     if (confirm) {
         ble_server_init();
         battery_start_curving();
-        page_manager_request_update(false);
+        page_manager_request_update(EPD_UPDATE_NORMAL);
     }
 }
 
@@ -71,12 +71,12 @@ bool battery_page_key_click(key_event_id_t key_event_type) {
         case KEY_OK_SHORT_CLICK:
             if (!battery_is_curving()) {
                 page_manager_show_menu("confirm-alert", &confirm_start_curving_arg);
-                page_manager_request_update(false);
+                page_manager_request_update(EPD_UPDATE_NORMAL);
             }
             return true;
         case KEY_FN_SHORT_CLICK:
             page_manager_close_page();
-            page_manager_request_update(false);
+            page_manager_request_update(EPD_UPDATE_NORMAL);
             return true;
         default:
             break;
@@ -33,14 +33,14 @@ static void ble_event_handler(void *event_handler_arg, esp_event_base_t event_ba
             break;
         case BT_START_SCAN:
             scanning = true;
-            page_manager_request_update(false);
+            page_manager_request_update(EPD_UPDATE_NORMAL);
             break;
         case BT_STOP_SCAN:
             scanning = false;
-            page_manager_request_update(false);
+            page_manager_request_update(EPD_UPDATE_NORMAL);
             break;
         case BT_NEW_SCAN_RESULT:
-            page_manager_request_update(false);
+            page_manager_request_update(EPD_UPDATE_NORMAL);
             break;
     }
 }
@@ -120,8 +120,8 @@ static void change_select(bool next) {
 
     ESP_LOGI(TAG, "current index:%d, current offset:%d", current_index, offset_item);
 
-    int full_update = 0;
-    common_post_event_data(BIKE_REQUEST_UPDATE_DISPLAY_EVENT, 0, &full_update, sizeof(full_update));
+    // moving selection in list, keep partial refresh
+    page_manager_request_update(EPD_UPDATE_NO_FLASH);
 }
 
 static void handle_click_event() {
@@ -135,7 +135,7 @@ static void handle_click_event() {
         scan_result_t *scan_rst = ble_device_get_scan_rst(&scan_rst_count);
         ble_device_connect(scan_rst[current_index - 1].addr);
     }
-    page_manager_request_update(false);
+    page_manager_request_update(EPD_UPDATE_NORMAL);
 }
 
 bool ble_device_page_key_click(key_event_id_t key_event_type) {
@@ -83,7 +83,7 @@ void confirm_menu_page_after_draw(uint32_t loop_cnt) {
 static void change_select(bool next) {
     switching_index = xTaskGetTickCount();
     current_index = (current_index + MENU_ITEM_COUNT + (next ? 1 : -1)) % MENU_ITEM_COUNT;
-    page_manager_request_update(false);
+    page_manager_request_update(EPD_UPDATE_NORMAL);
 }
 
 bool confirm_menu_page_key_click(key_event_id_t key_event_type) {
@@ -97,11 +97,11 @@ bool confirm_menu_page_key_click(key_event_id_t key_event_type) {
                 confirm_menu_arg->callback(current_index == 1);
             }
             page_manager_close_menu();
-            page_manager_request_update(false);
+            page_manager_request_update(EPD_UPDATE_NORMAL);
             break;
         case KEY_FN_SHORT_CLICK:
             page_manager_close_menu();
-            page_manager_request_update(false);
+            page_manager_request_update(EPD_UPDATE_NORMAL);
             break;
         case KEY_DOWN_SHORT_CLICK:
             change_select(true);
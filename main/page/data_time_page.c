@@ -61,7 +61,7 @@ static void tem_hum_event_handler(void *arg, esp_event_base_t event_base, int32_
 
             if (temperature_valid == false) {
                 ESP_LOGI(TAG, "temp current is invalid request update...");
-                page_manager_request_update(false);
+                page_manager_request_update(EPD_UPDATE_NORMAL);
             }
             temperature_valid = true;
             humility_valid = true;
@@ -159,9 +159,7 @@ void date_time_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt) {
 #ifdef CONFIG_BT_BLUEDROID_ENABLED
     if (esp_bluedroid_get_status() == ESP_BLUEDROID_STATUS_ENABLED) {
         // ble icon
-        epd_paint_draw_bitmap(epd_paint, icon_x, 183, 11, 16,
-                              (uint8_t *) icon_ble_bmp_start,
-                              icon_ble_bmp_end - icon_ble_bmp_start, 1);
+        epd_paint_draw_icon(epd_paint, ICON_STATUS_BLE, icon_x, 183, 1);
         icon_x += 15;
     }
 #endif
@@ -178,7 +176,7 @@ bool date_time_page_key_click(key_event_id_t key_event_type) {
                     .auto_close_ms = 5000
             };
             page_manager_show_menu("alert-dialog", &alert_dialog_arg);
-            page_manager_request_update(false);
+            page_manager_request_update(EPD_UPDATE_NORMAL);
             return true;
         }
         default:
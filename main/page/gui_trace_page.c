@@ -0,0 +1,100 @@
+#include <string.h>
+
+#include "esp_log.h"
+
+#include "gui_trace_page.h"
+#include "lcd/epd_lcd_ssd1680.h"
+#include "lcd/gui_trace.h"
+#include "page_manager.h"
+
+#define TAG "gui-trace-page"
+
+#define TRACE_ROW_HEIGHT 13
+#define TRACE_PAGE_ROWS 10
+
+static char trace_page_text_buf[40] = {0};
+static gui_trace_frame_t trace_frames[TRACE_PAGE_ROWS];
+
+/**
+ * append ms between two stages, "-" if any of them not reached
+ */
+static void append_span(char *buf, int width, int32_t from_us, int32_t to_us) {
+    size_t len = strlen(buf);
+    if (from_us == GUI_TRACE_NOT_SET || to_us == GUI_TRACE_NOT_SET) {
+        snprintf(buf + len, sizeof(trace_page_text_buf) - len, "%*s", width, "-");
+    } else {
+        snprintf(buf + len, sizeof(trace_page_text_buf) - len, "%*ld", width, (long) ((to_us - from_us) / 1000));
+    }
+}
+
+void gui_trace_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt) {
+    epd_paint_clear(epd_paint, 0);
+    epd_paint_draw_string_at(epd_paint, 0, 0, "gui trace ms", &Font16, 1);
+
+    // wt: input to wake, in: panel init, dr: draw, up: upload, rf: to refresh start, bz: refresh busy
+    uint16_t y = 18;
+    sprintf(trace_page_text_buf, "%2s%1s%4s%4s%4s%4s%4s%5s", "lp", "m", "wt", "in", "dr", "up", "rf", "bz");
+    epd_paint_draw_string_at(epd_paint, 0, y, trace_page_text_buf, &Font12, 1);
+    epd_paint_draw_horizontal_line(epd_paint, 0, y + TRACE_ROW_HEIGHT - 1, LCD_H_RES, 1);
+    y += TRACE_ROW_HEIGHT;
+
+    // newest frame is this draw itself, its upload and refresh are still to come
+    uint8_t count = gui_trace_get_frames(trace_frames, TRACE_PAGE_ROWS);
+    int32_t last_key_to_pixel = GUI_TRACE_NOT_SET, max_key_to_pixel = GUI_TRACE_NOT_SET;
+    for (uint8_t i = 0; i < count; i++) {
+        const gui_trace_frame_t *frame = &trace_frames[i];
+        const int32_t *stage = frame->stage_us;
+        char mode = (frame->flags & GUI_TRACE_FLAG_FULL_REFRESH) ? 'F'
+                    : (frame->flags & GUI_TRACE_FLAG_SKIPPED) ? 'S' : 'P';
+        int32_t input = stage[GUI_TRACE_KEY] != GUI_TRACE_NOT_SET ? stage[GUI_TRACE_KEY] : stage[GUI_TRACE_NOTIFY];
+
+        sprintf(trace_page_text_buf, "%02ld%c", (long) (frame->loop_cnt % 100), mode);
+        append_span(trace_page_text_buf, 4, input, 0);
+        append_span(trace_page_text_buf, 4, 0, stage[GUI_TRACE_DRAW_START]);
+        append_span(trace_page_text_buf, 4, stage[GUI_TRACE_DRAW_START], stage[GUI_TRACE_DRAW_DONE]);
+        append_span(trace_page_text_buf, 4, stage[GUI_TRACE_DRAW_DONE], stage[GUI_TRACE_UPLOAD_DONE]);
+        append_span(trace_page_text_buf, 4, stage[GUI_TRACE_UPLOAD_DONE], stage[GUI_TRACE_REFRESH_START]);
+        append_span(trace_page_text_buf, 5, stage[GUI_TRACE_REFRESH_START], stage[GUI_TRACE_BUSY_RELEASE]);
+        epd_paint_draw_string_at(epd_paint, 0, y, trace_page_text_buf, &Font12, 1);
+        y += TRACE_ROW_HEIGHT;
+
+        if (stage[GUI_TRACE_KEY] != GUI_TRACE_NOT_SET && stage[GUI_TRACE_BUSY_RELEASE] != GUI_TRACE_NOT_SET) {
+            int32_t key_to_pixel = stage[GUI_TRACE_BUSY_RELEASE] - stage[GUI_TRACE_KEY];
+            if (last_key_to_pixel == GUI_TRACE_NOT_SET) {
+                last_key_to_pixel = key_to_pixel;
+            }
+            if (max_key_to_pixel == GUI_TRACE_NOT_SET || key_to_pixel > max_key_to_pixel) {
+                max_key_to_pixel = key_to_pixel;
+            }
+        }
+    }
+
+    trace_page_text_buf[0] = '\0';
+    strcat(trace_page_text_buf, "key>px last");
+    append_span(trace_page_text_buf, 5, 0, last_key_to_pixel);
+    strcat(trace_page_text_buf, " max");
+    append_span(trace_page_text_buf, 5, 0, max_key_to_pixel);
+    epd_paint_draw_string_at(epd_paint, 0, LCD_V_RES - TRACE_ROW_HEIGHT, trace_page_text_buf, &Font12, 1);
+}
+
+bool gui_trace_page_key_click(key_event_id_t key_event_type) {
+    switch (key_event_type) {
+        case KEY_FN_SHORT_CLICK:
+        case KEY_OK_SHORT_CLICK:
+            page_manager_close_page();
+            page_manager_request_update(EPD_UPDATE_NORMAL);
+            return true;
+        case KEY_UP_SHORT_CLICK:
+        case KEY_DOWN_SHORT_CLICK:
+            // redraw with newest frames
+            page_manager_request_update(EPD_UPDATE_NO_FLASH);
+            return true;
+        default:
+            break;
+    }
+    return false;
+}
+
+int gui_trace_page_on_enter_sleep(void *args) {
+    return DEFAULT_SLEEP_TS;
+}
@@ -0,0 +1,13 @@
+#ifndef GUI_TRACE_PAGE_H
+#define GUI_TRACE_PAGE_H
+
+#include "lcd/epdpaint.h"
+#include "lcd/display.h"
+
+void gui_trace_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt);
+
+bool gui_trace_page_key_click(key_event_id_t key_event_type);
+
+int gui_trace_page_on_enter_sleep(void *args);
+
+#endif
@@ -14,7 +14,6 @@
 #include "image_page.h"
 #include "lcd/epd_lcd_ssd1680.h"
 #include "static/static.h"
-#include <dirent.h>
 #include "esp_vfs.h"
 
 #include "confirm_menu_page.h"
@@ -22,6 +21,9 @@
 #include "page_manager.h"
 #include "bles/ble_server.h"
 #include "file/my_file_common.h"
+#include "file/image_cache.h"
+#include "file/image_index.h"
+#include "file/image_prefetch.h"
 #include "battery.h"
 #include "view/battery_view.h"
 
@@ -34,12 +36,27 @@
     (strcasecmp(&filename[strlen(filename) - sizeof(ext) + 1], ext) == 0)
 
 RTC_DATA_ATTR static int16_t current_bitmap_page_index = 0;
-RTC_DATA_ATTR static int16_t total_image_file_count = -1;
 
 static char current_filepath[64];
 bool file_system_mounted = false;
 
-static void calc_total_image_file_count();
+// dither of an image is picked by a tag at the end of file name, like cat_atk.bmp, floyd steinberg if none
+static const struct {
+    const char *tag;
+    dither_mode_t mode;
+} dither_tags[] = {
+        {"_fs",  DITHER_FLOYD_STEINBERG},
+        {"_atk", DITHER_ATKINSON},
+        {"_b4",  DITHER_BAYER_4},
+        {"_b8",  DITHER_BAYER_8},
+        {"_th",  DITHER_THRESHOLD},
+};
+
+// ok double click tries other dither on current image, -1 use tag of file
+static int8_t dither_mode_override = -1;
+
+// direction of last up / down key, image that way is prefetched
+static int8_t browse_step = 1;
 
 static void delete_menu_callback(bool confirm);
 
@@ -125,26 +142,76 @@ void testBmp(uint8_t *data, uint16_t data_len) {
     ESP_LOGI(TAG, "pixel : x:%d, y:%d blue:%d green:%d red:%d", 0, 0, color.blue, color.green, color.red);
 }
 
-void display_file(epd_paint_t *epd_paint, uint32_t loop_cnt, char *file_name, uint16_t file_size) {
-    ESP_LOGI(TAG, "display image file %s", file_name);
+static dither_mode_t get_file_dither_mode(const char *file_name) {
+    const char *ext = strrchr(file_name, '.');
+    size_t name_len = ext != NULL ? ext - file_name : strlen(file_name);
+    for (uint8_t i = 0; i < sizeof(dither_tags) / sizeof(dither_tags[0]); i++) {
+        size_t tag_len = strlen(dither_tags[i].tag);
+        if (name_len >= tag_len && strncasecmp(file_name + name_len - tag_len, dither_tags[i].tag, tag_len) == 0) {
+            return dither_tags[i].mode;
+        }
+    }
+    return DITHER_FLOYD_STEINBERG;
+}
+
+static bool draw_image_file(epd_paint_t *epd_paint, const char *file_name, dither_mode_t dither_mode) {
     FILE *img_file = fopen(file_name, "r");
     if (img_file == NULL) {
         ESP_LOGE(TAG, "open image file %s failed", file_name);
-        current_bitmap_page_index = 0;
-        image_page_draw(epd_paint, loop_cnt);
-        return;
+        return false;
     }
+    if (IS_FILE_EXT(file_name, ".bmp")) {
+        epd_paint_draw_bitmap_file(epd_paint, 0, 0, LCD_H_RES, LCD_V_RES, img_file, dither_mode, 1);
+    } else if (IS_FILE_EXT(file_name, ".epi")) {
+        // already 1 bit, no dither
+        epd_paint_draw_epi_file(epd_paint, 0, 0, LCD_H_RES, LCD_V_RES, img_file, 1);
+    } else {
+        epd_paint_draw_jpg_file(epd_paint, 0, 0, LCD_H_RES, LCD_V_RES, img_file, dither_mode, 1);
+    }
+    fclose(img_file);
+    return true;
+}
 
+void display_file(epd_paint_t *epd_paint, uint32_t loop_cnt, char *file_name, const struct stat *file_stat) {
+    ESP_LOGI(TAG, "display image file %s", file_name);
     strcpy(current_filepath, file_name);
 
-    if (IS_FILE_EXT(file_name, ".bmp")) {
-        epd_paint_draw_bitmap_file(epd_paint, 0, 0, LCD_H_RES, LCD_V_RES, img_file, 1);
-        ESP_LOGI(TAG, "display bmp file %s finish", file_name);
+    dither_mode_t dither_mode = dither_mode_override >= 0 ? dither_mode_override : get_file_dither_mode(file_name);
+    uint16_t frame_size = epd_paint->stride * epd_paint->height;
+    // reading epi costs no more than reading its cached frame
+    bool cacheable = !IS_FILE_EXT(file_name, ".epi");
+    if (cacheable && image_cache_load(file_name, file_stat, epd_paint->rotate, dither_mode, epd_paint->image,
+                                      frame_size)) {
+        epd_paint_mark_dirty(epd_paint, 0, 0, epd_paint->width, epd_paint->height);
+        ESP_LOGI(TAG, "display image file %s from cache", file_name);
+    } else if (cacheable && image_prefetch_take(file_name, file_stat, epd_paint->rotate, dither_mode,
+                                                epd_paint->image, frame_size)) {
+        epd_paint_mark_dirty(epd_paint, 0, 0, epd_paint->width, epd_paint->height);
+        ESP_LOGI(TAG, "display image file %s from prefetch", file_name);
+        image_cache_store(file_name, file_stat, epd_paint->rotate, dither_mode, epd_paint->image, frame_size);
     } else {
-        epd_paint_draw_jpg_file(epd_paint, 0, 0, LCD_H_RES, LCD_V_RES, img_file, file_size, 1);
-        ESP_LOGI(TAG, "display jpg file %s finish", file_name);
+        // a broken cache entry may have been read in part
+        epd_paint_clear(epd_paint, 0);
+        if (!draw_image_file(epd_paint, file_name, dither_mode)) {
+            // index out of date
+            image_index_rebuild();
+            current_bitmap_page_index = 0;
+            image_page_draw(epd_paint, loop_cnt);
+            return;
+        }
+        ESP_LOGI(TAG, "display image file %s dither:%s finish", file_name, dither_mode_name(dither_mode));
+        if (cacheable) {
+            image_cache_store(file_name, file_stat, epd_paint->rotate, dither_mode, epd_paint->image, frame_size);
+        }
+    }
+
+    if (dither_mode_override >= 0) {
+        // show which dither is tried
+        const char *name = dither_mode_name(dither_mode);
+        int label_width = epd_paint_calc_string_width(epd_paint, name, &Font12);
+        epd_paint_draw_filled_rectangle(epd_paint, 0, 0, label_width + 3, 13, 0);
+        epd_paint_draw_string_at(epd_paint, 2, 1, name, &Font12, 1);
     }
-    fclose(img_file);
 }
 
 void image_page_on_create(void *arg) {
@@ -154,83 +221,59 @@ void image_page_on_create(void *arg) {
         file_system_mounted = false;
     } else {
         file_system_mounted = true;
+        image_index_load();
     }
 }
 
-static bool
-check_is_valid_image_file(struct dirent *entry, char *entrypath, size_t dirpath_len, struct stat *entry_stat) {
-    if (entry->d_type != DT_REG) {
-        return false;
+/**
+ * decode image next key likely goes to while panel refreshes, skipped if it is cached already
+ */
+static void prefetch_next_image(epd_paint_t *epd_paint) {
+    uint16_t count = image_index_count();
+    int32_t next_index = current_bitmap_page_index + browse_step;
+    if (next_index < 0) {
+        next_index += count + 1;
     }
-
-    strlcpy(entrypath + dirpath_len, entry->d_name, sizeof(entrypath) - dirpath_len);
-    if (stat(entrypath, entry_stat) == -1) {
-        ESP_LOGE(TAG, "Failed to stat %s", entry->d_name);
-        return false;;
+    if (next_index == 0 || next_index > count) {
+        // default image is not a file
+        return;
     }
-    static char entrysize[16];
-    sprintf(entrysize, "%ld", (*entry_stat).st_size);
-    ESP_LOGI(TAG, "Found %s (%s bytes)", entry->d_name, entrysize);
 
-    if ((*entry_stat).st_size > MAX_FILE_SIZE) {
-        return false;;
+    image_index_entry_t entry;
+    if (!image_index_get(next_index - 1, &entry)) {
+        return;
     }
-
-    if (!IS_FILE_EXT(entry->d_name, ".bmp") && !IS_FILE_EXT(entry->d_name, ".jpg")) {
-        return false;;
+    char entrypath[64];
+    struct stat entry_stat;
+    image_index_entry_path(&entry, entrypath, sizeof(entrypath));
+    image_index_entry_stat(&entry, &entry_stat);
+    if (IS_FILE_EXT(entrypath, ".epi")) {
+        // drawn quick enough without
+        return;
     }
-    return true;
+    dither_mode_t dither_mode = get_file_dither_mode(entrypath);
+    if (image_cache_contains(entrypath, &entry_stat, epd_paint->rotate, dither_mode,
+                             epd_paint->stride * epd_paint->height)) {
+        return;
+    }
+    image_prefetch_start(entrypath, &entry_stat, epd_paint->rotate, dither_mode, draw_image_file);
 }
 
 void image_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt) {
     epd_paint_clear(epd_paint, 0);
     if (current_bitmap_page_index == 0) {
-        epd_paint_draw_bitmap(epd_paint, 0, 0, LCD_H_RES, LCD_V_RES, (uint8_t *) aniya_200_1_bmp_start,
-                              aniya_200_1_bmp_end - aniya_200_1_bmp_start, 1);
+        epd_paint_draw_epi(epd_paint, 0, 0, LCD_H_RES, LCD_V_RES, aniya_200_1_epi_start,
+                           aniya_200_1_epi_end - aniya_200_1_epi_start, 1);
     } else if (file_system_mounted) {
-        // read from file
-        bool finded = false;
-
-        char entrypath[64];
-
-        struct dirent *entry;
-        struct stat entry_stat;
-
-        /* Retrieve the base path of file storage to construct the full path */
-        strcpy(entrypath, FILE_SERVER_BASE_PATH);
-        strlcpy(entrypath + strlen(FILE_SERVER_BASE_PATH), "/", sizeof(entrypath) - strlen(FILE_SERVER_BASE_PATH));
-
-        ESP_LOGI(TAG, "open dir %s", entrypath);
-        DIR *dir = opendir(entrypath);
-        const size_t dirpath_len = strlen(entrypath);
-
-        if (!dir) {
-            ESP_LOGE(TAG, "Failed to stat dir : %s", entrypath);
+        // files start from 1 because has one default image
+        image_index_entry_t entry;
+        if (image_index_get(current_bitmap_page_index - 1, &entry)) {
+            char entrypath[64];
+            struct stat entry_stat;
+            image_index_entry_path(&entry, entrypath, sizeof(entrypath));
+            image_index_entry_stat(&entry, &entry_stat);
+            display_file(epd_paint, loop_cnt, entrypath, &entry_stat);
         } else {
-            ESP_LOGI(TAG, "list dir : %s", entrypath);
-            uint16_t curr_file_index = 1; // start from 1 because has one default image
-            /* Iterate over all files / folders and fetch their names and sizes */
-            while ((entry = readdir(dir)) != NULL) {
-                if (!check_is_valid_image_file(entry, entrypath, dirpath_len, &entry_stat)) {
-                    continue;
-                }
-
-                if (current_bitmap_page_index == curr_file_index) {
-                    // finded
-                    finded = true;
-                    strlcpy(entrypath + dirpath_len, entry->d_name, sizeof(entrypath) - dirpath_len);
-                    display_file(epd_paint, loop_cnt, entrypath, entry_stat.st_size);
-                    // break; not break to calc total file count
-                }
-
-                curr_file_index++;
-            }
-
-            total_image_file_count = curr_file_index;
-            closedir(dir);
-        }
-
-        if (!finded) {
             current_bitmap_page_index = 0;
             image_page_draw(epd_paint, loop_cnt);
         }
@@ -240,6 +283,10 @@ void image_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt) {
         image_page_draw(epd_paint, loop_cnt);
     }
 
+    if (file_system_mounted) {
+        prefetch_next_image(epd_paint);
+    }
+
     // draw battery icon if battery low
     int8_t battery_level = battery_get_level();
     if (battery_level >= 0 && battery_level < 20) {
@@ -249,37 +296,6 @@ void image_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt) {
     }
 }
 
-static void calc_total_image_file_count() {
-    char entrypath[64];
-    struct dirent *entry;
-    /* Retrieve the base path of file storage to construct the full path */
-    strcpy(entrypath, FILE_SERVER_BASE_PATH);
-    strlcpy(entrypath + strlen(FILE_SERVER_BASE_PATH), "/", sizeof(entrypath) - strlen(FILE_SERVER_BASE_PATH));
-
-    DIR *dir = opendir(entrypath);
-    const size_t dirpath_len = strlen(entrypath);
-    struct stat entry_stat;
-
-    if (!dir) {
-        ESP_LOGE(TAG, "Failed to stat dir : %s", entrypath);
-        total_image_file_count = 1;
-    } else {
-        ESP_LOGI(TAG, "list dir : %s", entrypath);
-        uint16_t valid_file_count = 1;
-        /* Iterate over all files / folders and fetch their names and sizes */
-        while ((entry = readdir(dir)) != NULL) {
-            if (!check_is_valid_image_file(entry, entrypath, dirpath_len, &entry_stat)) {
-                continue;
-            }
-            valid_file_count++;
-        }
-
-        total_image_file_count = valid_file_count;
-        ESP_LOGI(TAG, "calc total file count %d", total_image_file_count);
-        closedir(dir);
-    }
-}
-
 static esp_err_t delete_current_image() {
     if (current_bitmap_page_index == 0) {
         return ESP_FAIL;
@@ -292,10 +308,9 @@ static esp_err_t delete_current_image() {
     }
 
     unlink(current_filepath);
+    image_cache_remove(current_filepath);
+    image_index_remove(current_filepath);
     current_bitmap_page_index -= 1;
-    if (total_image_file_count > 0) {
-        total_image_file_count -= 1;
-    }
 
     ESP_LOGI(TAG, "delete file %s", current_filepath);
     return ESP_OK;
@@ -304,23 +319,35 @@ static esp_err_t delete_current_image() {
 bool image_page_key_click_handle(key_event_id_t key_event_type) {
     switch (key_event_type) {
         case KEY_UP_SHORT_CLICK:
+            dither_mode_override = -1;
+            browse_step = -1;
             current_bitmap_page_index -= 1;
             if (current_bitmap_page_index < 0) {
-                if (total_image_file_count < 0) {
-                    calc_total_image_file_count();
-                }
-                current_bitmap_page_index += total_image_file_count;
+                current_bitmap_page_index += (file_system_mounted ? image_index_count() : 0) + 1;
             }
-            page_manager_request_update(false);
+            page_manager_request_update(EPD_UPDATE_NORMAL);
             return true;
         case KEY_DOWN_SHORT_CLICK:
+            dither_mode_override = -1;
+            browse_step = 1;
             current_bitmap_page_index += 1;
-            page_manager_request_update(false);
+            page_manager_request_update(EPD_UPDATE_NORMAL);
+            return true;
+        case KEY_OK_DB_CLICK:
+            if (current_bitmap_page_index == 0) {
+                // default image is black and white already
+                return false;
+            }
+            if (dither_mode_override < 0) {
+                dither_mode_override = get_file_dither_mode(current_filepath);
+            }
+            dither_mode_override = (dither_mode_override + 1) % DITHER_MODE_COUNT;
+            page_manager_request_update(EPD_UPDATE_NORMAL);
             return true;
         case KEY_FN_SHORT_CLICK:
             // show delete menu
             page_manager_show_menu("confirm-alert", &confirm_menu_arg);
-            page_manager_request_update(false);
+            page_manager_request_update(EPD_UPDATE_NORMAL);
             return true;
         case KEY_FN_LONG_CLICK: {
             // show alert dialog
@@ -331,7 +358,7 @@ bool image_page_key_click_handle(key_event_id_t key_event_type) {
                     .auto_close_ms = 5000
             };
             page_manager_show_menu("alert-dialog", &alert_dialog_arg);
-            page_manager_request_update(false);
+            page_manager_request_update(EPD_UPDATE_NORMAL);
             return true;
         }
         default:
@@ -342,10 +369,13 @@ bool image_page_key_click_handle(key_event_id_t key_event_type) {
 }
 
 void image_page_on_destroy(void *arg) {
+    // prefetch reads storage
+    image_prefetch_stop();
     unmount_storage();
     file_system_mounted = false;
 }
 
 int image_page_on_enter_sleep(void *args) {
+    image_prefetch_stop();
     return 5400;
 }
\ No newline at end of file
@@ -33,7 +33,11 @@ extern uint32_t boot_count;
 bool info_page_key_click(key_event_id_t key_event_type) {
     if (key_event_type == KEY_FN_SHORT_CLICK || key_event_type == KEY_OK_SHORT_CLICK) {
         page_manager_close_page();
-        page_manager_request_update(false);
+        page_manager_request_update(EPD_UPDATE_NORMAL);
+        return true;
+    } else if (key_event_type == KEY_OK_LONG_CLICK) {
+        page_manager_switch_page("gui-trace", true);
+        page_manager_request_update(EPD_UPDATE_NORMAL);
         return true;
     }
     return false;
@@ -27,7 +27,7 @@ bool manual_page_key_click(key_event_id_t key_event_type) {
         case KEY_FN_SHORT_CLICK:
         case KEY_OK_SHORT_CLICK:
             page_manager_close_page();
-            page_manager_request_update(false);
+            page_manager_request_update(EPD_UPDATE_NORMAL);
             return true;
         default:
             return false;
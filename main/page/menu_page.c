@@ -23,7 +23,7 @@ RTC_DATA_ATTR static esp_timer_handle_t auto_close_timer_hdl = NULL;
 static void auto_close_timer_callback(void *arg) {
     ESP_LOGI(TAG, "auto close menu triggered");
     page_manager_close_menu();
-    page_manager_request_update(false);
+    page_manager_request_update(EPD_UPDATE_NORMAL);
 }
 
 void menu_page_on_create(void *arg) {
@@ -57,27 +57,19 @@ void menu_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt) {
 
     // draw icon
     // 0. home
-    epd_paint_draw_bitmap(epd_paint, 8, starty + 4, 35, 32,
-                          (uint8_t *) ic_home_bmp_start,
-                          ic_home_bmp_end - ic_home_bmp_start, 1);
+    epd_paint_draw_icon(epd_paint, ICON_HOME, 8, starty + 4, 1);
     epd_paint_draw_string_at(epd_paint, 9, starty + 38, (char *) text_home, &Font_HZK16, 1);
 
     // 1. image
-    epd_paint_draw_bitmap(epd_paint, MENU_ITEM_WIDTH + 7, starty + 4, 36, 32,
-                          (uint8_t *) ic_image_bmp_start,
-                          ic_image_bmp_end - ic_image_bmp_start, 1);
+    epd_paint_draw_icon(epd_paint, ICON_IMAGE, MENU_ITEM_WIDTH + 7, starty + 4, 1);
     epd_paint_draw_string_at(epd_paint, MENU_ITEM_WIDTH + 9, starty + 38, (char *) text_image, &Font_HZK16, 1);
 
     // 2. time
-    epd_paint_draw_bitmap(epd_paint, MENU_ITEM_WIDTH * 2 + 8, starty + 4, 32, 32,
-                          (uint8_t *) ic_time_bmp_start,
-                          ic_time_bmp_end - ic_time_bmp_start, 1);
+    epd_paint_draw_icon(epd_paint, ICON_TIME, MENU_ITEM_WIDTH * 2 + 8, starty + 4, 1);
     epd_paint_draw_string_at(epd_paint, MENU_ITEM_WIDTH * 2 + 9, starty + 38, (char *) text_time, &Font_HZK16, 1);
 
     // 3. alarm
-    epd_paint_draw_bitmap(epd_paint, MENU_ITEM_WIDTH * 3 + 8, starty + 4, 32, 32,
-                          (uint8_t *) ic_alarm_bmp_start,
-                          ic_alarm_bmp_end - ic_alarm_bmp_start, 1);
+    epd_paint_draw_icon(epd_paint, ICON_ALARM, MENU_ITEM_WIDTH * 3 + 8, starty + 4, 1);
 
     epd_paint_draw_string_at(epd_paint, MENU_ITEM_WIDTH * 3 + 9, starty + 38, (char *) text_alarm_clock, &Font_HZK16, 1);
 
@@ -86,27 +78,19 @@ void menu_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt) {
     starty += MENU_ITEM_HEIGHT;
 
     // 4. tomato
-    epd_paint_draw_bitmap(epd_paint, 8, starty + 4, 32, 32,
-                          (uint8_t *) ic_tomato_bmp_start,
-                          ic_tomato_bmp_end - ic_tomato_bmp_start, 1);
+    epd_paint_draw_icon(epd_paint, ICON_TOMATO, 8, starty + 4, 1);
     epd_paint_draw_string_at(epd_paint, 9, starty + 38, (char *) text_tomato, &Font_HZK16, 1);
 
     // 5. ble
-    epd_paint_draw_bitmap(epd_paint, MENU_ITEM_WIDTH + 7, starty + 4, 36, 32,
-                          (uint8_t *) ic_ble_bmp_start,
-                          ic_ble_bmp_end - ic_ble_bmp_start, 1);
+    epd_paint_draw_icon(epd_paint, ICON_BLE, MENU_ITEM_WIDTH + 7, starty + 4, 1);
     epd_paint_draw_string_at(epd_paint, MENU_ITEM_WIDTH + 9, starty + 38, (char *) text_ble, &Font_HZK16, 1);
 
     // 6. setting
-    epd_paint_draw_bitmap(epd_paint, MENU_ITEM_WIDTH * 2 + 8, starty + 4, 33, 32,
-                          (uint8_t *) ic_setting_bmp_start,
-                          ic_setting_bmp_end - ic_setting_bmp_start, 1);
+    epd_paint_draw_icon(epd_paint, ICON_SETTING, MENU_ITEM_WIDTH * 2 + 8, starty + 4, 1);
     epd_paint_draw_string_at(epd_paint, MENU_ITEM_WIDTH * 2 + 9, starty + 38, (char *) text_setting, &Font_HZK16, 1);
 
     // 7. close
-    epd_paint_draw_bitmap(epd_paint, MENU_ITEM_WIDTH * 3 + 8, starty + 4, 32, 32,
-                          (uint8_t *) ic_close_bmp_start,
-                          ic_close_bmp_end - ic_close_bmp_start, 1);
+    epd_paint_draw_icon(epd_paint, ICON_CLOSE, MENU_ITEM_WIDTH * 3 + 8, starty + 4, 1);
 
     epd_paint_draw_string_at(epd_paint, MENU_ITEM_WIDTH * 3 + 9, starty + 38, (char *) text_close, &Font_HZK16, 1);
 
@@ -122,8 +106,8 @@ void menu_page_after_draw(uint32_t loop_cnt) {
 
 static void change_select(bool next) {
     current_index = (current_index + MENU_ITEM_COUNT + (next ? 1 : -1)) % MENU_ITEM_COUNT;
-    int full_update = 0;
-    common_post_event_data(BIKE_REQUEST_UPDATE_DISPLAY_EVENT, 0, &full_update, sizeof(full_update));
+    // moving selection in list, keep partial refresh
+    page_manager_request_update(EPD_UPDATE_NO_FLASH);
 }
 
 void handle_setting_item_event() {
@@ -147,12 +131,12 @@ void handle_setting_item_event() {
                 .auto_close_ms = 5000
         };
         page_manager_show_menu("alert-dialog", &alert_dialog_arg);
-        page_manager_request_update(false);
+        page_manager_request_update(EPD_UPDATE_NORMAL);
     }  else if (current_index == 6) {
         // setting
         page_manager_switch_page("setting-list", true);
     }
-    page_manager_request_update(false);
+    page_manager_request_update(EPD_UPDATE_NORMAL);
 }
 
 bool menu_page_key_click(key_event_id_t key_event_type) {
@@ -166,7 +150,7 @@ bool menu_page_key_click(key_event_id_t key_event_type) {
             break;
         case KEY_FN_SHORT_CLICK:
             page_manager_close_menu();
-            page_manager_request_update(false);
+            page_manager_request_update(EPD_UPDATE_NORMAL);
             break;
         case KEY_DOWN_SHORT_CLICK:
             if (lis3dh_get_direction() == LIS3DH_DIR_LEFT)  {
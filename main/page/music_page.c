@@ -66,15 +66,15 @@ bool music_page_key_click(key_event_id_t key_event_type) {
             return true;
         case KEY_FN_SHORT_CLICK:
             page_manager_close_page();
-            page_manager_request_update(false);
+            page_manager_request_update(EPD_UPDATE_NORMAL);
             return true;
         case KEY_UP_SHORT_CLICK:
             list_view_select_pre(list_view);
-            page_manager_request_update(false);
+            page_manager_request_update(EPD_UPDATE_NORMAL);
             return true;
         case KEY_DOWN_SHORT_CLICK:
             list_view_select_next(list_view);
-            page_manager_request_update(false);
+            page_manager_request_update(EPD_UPDATE_NORMAL);
             return true;
         default:
 
@@ -29,7 +29,7 @@ static void sensor_update_event_handler(void *arg, esp_event_base_t event_base,
     switch (event_id) {
         case SPL06_SENSOR_UPDATE: {
             _event_data = *(spl06_event_data_t *) event_data;
-            page_manager_request_update(false);
+            page_manager_request_update(EPD_UPDATE_NORMAL);
             break;
         }
         default:
@@ -39,7 +39,7 @@ static void sensor_update_event_handler(void *arg, esp_event_base_t event_base,
 
 bool pressure_sensor_page_key_click(key_event_id_t key_event_type) {
     page_manager_close_page();
-    page_manager_request_update(false);
+    page_manager_request_update(EPD_UPDATE_NORMAL);
     return true;
 }
 
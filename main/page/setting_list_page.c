@@ -37,9 +37,7 @@ void setting_list_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt) {
 
     if (offset_item < 1) {
         // 0 close
-        epd_paint_draw_bitmap(epd_paint, 15, y + PADDING_Y, 17, 32,
-                              (uint8_t *) ic_back_bmp_start,
-                              ic_back_bmp_end - ic_back_bmp_start, 1);
+        epd_paint_draw_icon(epd_paint, ICON_BACK, 15, y + PADDING_Y, 1);
         uint16_t close[] = {0xCBCD, 0xF6B3, 0x00};
         epd_paint_draw_string_at(epd_paint, SETTING_ITEM_HEIGHT + PADDING_X, y + TEXT_PADDING_Y,
                                  (char *) close, &Font_HZK16, 1);
@@ -48,9 +46,7 @@ void setting_list_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt) {
 
     if (offset_item < 2) {
         // 1. info
-        epd_paint_draw_bitmap(epd_paint, 9, y + PADDING_Y, 32, 32,
-                              (uint8_t *) ic_info_bmp_start,
-                              ic_info_bmp_end - ic_info_bmp_start, 1);
+        epd_paint_draw_icon(epd_paint, ICON_INFO, 9, y + PADDING_Y, 1);
         uint16_t info[] = {0xD8B9, 0xDAD3, 0x00};
         epd_paint_draw_string_at(epd_paint, SETTING_ITEM_HEIGHT + PADDING_X, y + TEXT_PADDING_Y,
                                  (char *) info, &Font_HZK16, 1);
@@ -59,9 +55,7 @@ void setting_list_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt) {
 
     if (offset_item < 3) {
         // 2. manual
-        epd_paint_draw_bitmap(epd_paint, 10, y + PADDING_Y, 30, 32,
-                              (uint8_t *) ic_manual_bmp_start,
-                              ic_manual_bmp_end - ic_manual_bmp_start, 1);
+        epd_paint_draw_icon(epd_paint, ICON_MANUAL, 10, y + PADDING_Y, 1);
         uint16_t manual[] = {0xB5CB, 0xF7C3, 0x00};
         epd_paint_draw_string_at(epd_paint, SETTING_ITEM_HEIGHT + PADDING_X, y + TEXT_PADDING_Y,
                                  (char *) manual, &Font_HZK16, 1);
@@ -70,9 +64,7 @@ void setting_list_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt) {
 
     if (offset_item < 4) {
         // 3. upload
-        epd_paint_draw_bitmap(epd_paint, 7, y + PADDING_Y, 30, 32,
-                              (uint8_t *) ic_image_bmp_start,
-                              ic_image_bmp_end - ic_image_bmp_start, 1);
+        epd_paint_draw_icon(epd_paint, ICON_IMAGE, 7, y + PADDING_Y, 1);
         uint16_t upload[] = {0xCFC9, 0xABB4, 0xBCCD, 0xACC6, 0x00};
         epd_paint_draw_string_at(epd_paint, SETTING_ITEM_HEIGHT + PADDING_X, y + TEXT_PADDING_Y,
                                  (char *) upload, &Font_HZK16, 1);
@@ -81,9 +73,7 @@ void setting_list_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt) {
 
     if (offset_item < 5) {
         // 4. music
-        epd_paint_draw_bitmap(epd_paint, 8, y + PADDING_Y, 32, 32,
-                              (uint8_t *) ic_music_bmp_start,
-                              ic_music_bmp_end - ic_music_bmp_start, 1);
+        epd_paint_draw_icon(epd_paint, ICON_MUSIC, 8, y + PADDING_Y, 1);
         uint16_t music[] = {0xF4D2, 0xD6C0, 0x00};
         epd_paint_draw_string_at(epd_paint, SETTING_ITEM_HEIGHT + PADDING_X, y + TEXT_PADDING_Y,
                                  (char *) music, &Font_HZK16, 1);
@@ -92,9 +82,7 @@ void setting_list_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt) {
 
     if (offset_item < 6) {
         // 5. PRESSURE
-        epd_paint_draw_bitmap(epd_paint, 8, y + PADDING_Y, 32, 32,
-                              (uint8_t *) ic_pressure_bmp_start,
-                              ic_pressure_bmp_end - ic_pressure_bmp_start, 1);
+        epd_paint_draw_icon(epd_paint, ICON_PRESSURE, 8, y + PADDING_Y, 1);
         epd_paint_draw_string_at(epd_paint, SETTING_ITEM_HEIGHT + PADDING_X, y + TEXT_PADDING_Y,
                                  (char *) text_pressure_sensor, &Font_HZK16, 1);
         y += SETTING_ITEM_HEIGHT;
@@ -102,9 +90,7 @@ void setting_list_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt) {
 #ifdef CONFIG_WIFI_ENABLED
     if (offset_item < 6) {
         // 5. upgrade
-        epd_paint_draw_bitmap(epd_paint, 8, y + PADDING_Y, 32, 32,
-                              (uint8_t *) ic_upgrade_bmp_start,
-                              ic_upgrade_bmp_end - ic_upgrade_bmp_start, 1);
+        epd_paint_draw_icon(epd_paint, ICON_UPGRADE, 8, y + PADDING_Y, 1);
         uint16_t upgrade[] = {0xFDC9, 0xB6BC, 0x00};
         epd_paint_draw_string_at(epd_paint, SETTING_ITEM_HEIGHT + PADDING_X, y + TEXT_PADDING_Y,
                                  (char *) upgrade, &Font_HZK16, 1);
@@ -114,9 +100,7 @@ void setting_list_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt) {
 
 //    if (offset_item < 7) {
 //        // 6. ble
-//        epd_paint_draw_bitmap(epd_paint, 11, y + PADDING_Y, 28, 32,
-//                              (uint8_t *) ic_ble_bmp_start,
-//                              ic_ble_bmp_end - ic_ble_bmp_start, 1);
+//        epd_paint_draw_icon(epd_paint, ICON_BLE, 11, y + PADDING_Y, 1);
 //        uint16_t ble_device[] = {0xB6C0, 0xC0D1, 0xE8C9, 0xB8B1, 0x00};
 //        epd_paint_draw_string_at(epd_paint, SETTING_ITEM_HEIGHT + PADDING_X, y + TEXT_PADDING_Y,
 //                                 (char *) ble_device, &Font_HZK16, 1);
@@ -124,9 +108,7 @@ void setting_list_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt) {
 //    }
     if (offset_item < 7) {
         // 6. battery
-        epd_paint_draw_bitmap(epd_paint, 9, y + PADDING_Y, 32, 32,
-                              (uint8_t *) ic_battery_bmp_start,
-                              ic_battery_bmp_end - ic_battery_bmp_start, 1);
+        epd_paint_draw_icon(epd_paint, ICON_BATTERY, 9, y + PADDING_Y, 1);
         uint16_t battery[] = {0xE7B5, 0xD8B3, 0x00};
         epd_paint_draw_string_at(epd_paint, SETTING_ITEM_HEIGHT + PADDING_X, y + TEXT_PADDING_Y,
                                  (char *) battery, &Font_HZK16, 1);
@@ -134,9 +116,7 @@ void setting_list_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt) {
     }
     if (offset_item < 8) {
         // 7. reboot
-        epd_paint_draw_bitmap(epd_paint, 9, y + PADDING_Y, 32, 32,
-                              (uint8_t *) ic_reboot_bmp_start,
-                              ic_reboot_bmp_end - ic_reboot_bmp_start, 1);
+        epd_paint_draw_icon(epd_paint, ICON_REBOOT, 9, y + PADDING_Y, 1);
         uint16_t reboot[] = {0xD8D6, 0xF4C6, 0x00};
         epd_paint_draw_string_at(epd_paint, SETTING_ITEM_HEIGHT + PADDING_X, y + TEXT_PADDING_Y,
                                  (char *) reboot, &Font_HZK16, 1);
@@ -170,8 +150,8 @@ static void change_select(bool next) {
 
     ESP_LOGI(TAG, "current index:%d, current offset:%d", current_index, offset_item);
 
-    int full_update = 0;
-    common_post_event_data(BIKE_REQUEST_UPDATE_DISPLAY_EVENT, 0, &full_update, sizeof(full_update));
+    // moving selection in list, keep partial refresh
+    page_manager_request_update(EPD_UPDATE_NO_FLASH);
 }
 
 static void handle_click_event() {
@@ -201,7 +181,7 @@ static void handle_click_event() {
     } else if (current_index == 7) {
         esp_restart();
     }
-    page_manager_request_update(false);
+    page_manager_request_update(EPD_UPDATE_NORMAL);
 }
 
 bool setting_list_page_key_click(key_event_id_t key_event_type) {
@@ -44,7 +44,7 @@ static void temp_sensor_event_handler(void *arg, esp_event_base_t event_base, in
 
             if (sht31_data_valid == false) {
                 ESP_LOGI(TAG, "temp current is invalid request update...");
-                page_manager_request_update(false);
+                page_manager_request_update(EPD_UPDATE_NORMAL);
             }
             sht31_data_valid = true;
             break;
@@ -126,9 +126,7 @@ void temperature_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt) {
 
     if (esp_bt_controller_get_status() == ESP_BT_CONTROLLER_STATUS_ENABLED) {
         // ble icon
-        epd_paint_draw_bitmap(epd_paint, icon_x, 183, 11, 16,
-                              (uint8_t *) icon_ble_bmp_start,
-                              icon_ble_bmp_end - icon_ble_bmp_start, 1);
+        epd_paint_draw_icon(epd_paint, ICON_STATUS_BLE, icon_x, 183, 1);
         icon_x += 15;
     }
 }
@@ -144,7 +142,7 @@ bool temperature_page_key_click_handle(key_event_id_t key_event_type) {
                     .auto_close_ms = 5000
             };
             page_manager_show_menu("alert-dialog", &alert_dialog_arg);
-            page_manager_request_update(false);
+            page_manager_request_update(EPD_UPDATE_NORMAL);
             return true;
         }
         default:
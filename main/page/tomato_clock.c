@@ -160,14 +160,12 @@ void tomato_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt) {
 
     switch (curr_stage) {
         case TOMATO_INIT:
-            epd_paint_draw_bitmap(epd_paint, (epd_paint->width - 32) / 2, 50, 32, 32, ic_tomato_bmp_start,
-                                  ic_tomato_bmp_end - ic_tomato_bmp_start, 1);
+            epd_paint_draw_icon(epd_paint, ICON_TOMATO, (epd_paint->width - 32) / 2, 50, 1);
             epd_paint_draw_string_at_hposition(epd_paint, 0, 140, epd_paint->width, (char *) text_start, &Font_HZK16,
                                                ALIGN_CENTER, 1);
             break;
         case TOMATO_SETTING_STUDY_TIME:
-            epd_paint_draw_bitmap(epd_paint, (epd_paint->width - 32) / 2, 50, 32, 32, ic_tomato_bmp_start,
-                                  ic_tomato_bmp_end - ic_tomato_bmp_start, 1);
+            epd_paint_draw_icon(epd_paint, ICON_TOMATO, (epd_paint->width - 32) / 2, 50, 1);
 
             sprintf(buff, "%d", study_time_min);
             epd_paint_draw_string_at_hposition(epd_paint, 0, 120, epd_paint->width, buff,
@@ -177,8 +175,7 @@ void tomato_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt) {
                                                &Font_HZK16, ALIGN_CENTER, 1);
             break;
         case TOMATO_SETTING_PLAY_TIME:
-            epd_paint_draw_bitmap(epd_paint, (epd_paint->width - 32) / 2, 50, 32, 32, ic_tomato_bmp_start,
-                                  ic_tomato_bmp_end - ic_tomato_bmp_start, 1);
+            epd_paint_draw_icon(epd_paint, ICON_TOMATO, (epd_paint->width - 32) / 2, 50, 1);
 
             sprintf(buff, "%d", play_time_min);
             epd_paint_draw_string_at_hposition(epd_paint, 0, 120, epd_paint->width, buff,
@@ -188,8 +185,7 @@ void tomato_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt) {
                                                &Font_HZK16, ALIGN_CENTER, 1);
             break;
         case TOMATO_SETTING_LOOP_COUNT:
-            epd_paint_draw_bitmap(epd_paint, (epd_paint->width - 32) / 2, 50, 32, 32, ic_tomato_bmp_start,
-                                  ic_tomato_bmp_end - ic_tomato_bmp_start, 1);
+            epd_paint_draw_icon(epd_paint, ICON_TOMATO, (epd_paint->width - 32) / 2, 50, 1);
 
             sprintf(buff, "%d", _loop_count);
             epd_paint_draw_string_at_hposition(epd_paint, 0, 120, epd_paint->width, buff,
@@ -202,8 +198,7 @@ void tomato_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt) {
             sprintf(buff, "%d/%d", curr_loop, _loop_count);
             epd_paint_draw_string_at(epd_paint, 0, 0, buff, &Font_HZK16, 1);
 
-            epd_paint_draw_bitmap(epd_paint, (epd_paint->width - 32) / 2, 50, 32, 32, ic_studying_bmp_start,
-                                  ic_studying_bmp_end - ic_studying_bmp_start, 1);
+            epd_paint_draw_icon(epd_paint, ICON_STUDYING, (epd_paint->width - 32) / 2, 50, 1);
             uint8_t passed_study_min = min(study_time_min, (_current_ts - study_start_ts) / 60);
             sprintf(buff, "%d/%d", passed_study_min, study_time_min);
             epd_paint_draw_string_at_hposition(epd_paint, 0, 120, epd_paint->width, buff,
@@ -216,8 +211,7 @@ void tomato_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt) {
             sprintf(buff, "%d/%d", curr_loop, _loop_count);
             epd_paint_draw_string_at(epd_paint, 0, 0, buff, &Font_HZK16, 1);
 
-            epd_paint_draw_bitmap(epd_paint, (epd_paint->width - 32) / 2, 50, 32, 32, ic_playing_bmp_start,
-                                  ic_playing_bmp_end - ic_playing_bmp_start, 1);
+            epd_paint_draw_icon(epd_paint, ICON_PLAYING, (epd_paint->width - 32) / 2, 50, 1);
             uint8_t passed_play_min = min(play_time_min, (_current_ts - play_start_ts) / 60);
             sprintf(buff, "%d/%d", passed_play_min, play_time_min);
             epd_paint_draw_string_at_hposition(epd_paint, 0, 120, epd_paint->width, buff,
@@ -227,8 +221,7 @@ void tomato_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt) {
                                                ALIGN_CENTER, 1);
             break;
         case TOMATO_SUMMARY:
-            epd_paint_draw_bitmap(epd_paint, (epd_paint->width - 32) / 2, 50, 32, 32, ic_summary_bmp_start,
-                                  ic_summary_bmp_end - ic_summary_bmp_start, 1);
+            epd_paint_draw_icon(epd_paint, ICON_SUMMARY, (epd_paint->width - 32) / 2, 50, 1);
             epd_paint_draw_string_at_hposition(epd_paint, 0, 140, epd_paint->width, (char *) text_summary, &Font_HZK16,
                                                ALIGN_CENTER, 1);
             break;
@@ -259,7 +252,7 @@ static void adjust_study_time(bool add) {
             study_time_min = STUDY_TIME_MIN;
         }
     }
-    page_manager_request_update(false);
+    page_manager_request_update(EPD_UPDATE_NORMAL);
 }
 
 static void adjust_play_time(bool add) {
@@ -283,7 +276,7 @@ static void adjust_play_time(bool add) {
             play_time_min = PLAY_TIME_MIN;
         }
     }
-    page_manager_request_update(false);
+    page_manager_request_update(EPD_UPDATE_NORMAL);
 }
 
 static void adjust_loop_count(bool add) {
@@ -305,7 +298,7 @@ static void adjust_loop_count(bool add) {
     if (_loop_count > LOOP_COUNT_MAX) {
         _loop_count = LOOP_COUNT_MAX;
     }
-    page_manager_request_update(false);
+    page_manager_request_update(EPD_UPDATE_NORMAL);
 }
 
 static void start_study() {
@@ -375,7 +368,7 @@ static void change_to_next_stage(bool refresh) {
     }
 
     if (refresh) {
-        page_manager_request_update(false);
+        page_manager_request_update(EPD_UPDATE_NORMAL);
     }
 }
 
@@ -392,7 +385,7 @@ bool tomato_page_key_click(key_event_id_t key_event_type) {
                 // skip
                 confirm_menu_arg.callback = confirm_skip_stage_callback;
                 page_manager_show_menu("confirm-alert", &confirm_menu_arg);
-                page_manager_request_update(false);
+                page_manager_request_update(EPD_UPDATE_NORMAL);
             } else {
                 // next stage
                 change_to_next_stage(true);
@@ -50,10 +50,10 @@ enum upgrade_state_t state = INIT;
 //    if (event_id == OTA_PROGRESS) {
 //        if (ota_progress - last_ota_update_progress >= 0.003) {
 //            last_ota_update_progress = ota_progress;
-//            page_manager_request_update(false);
+//            page_manager_request_update(EPD_UPDATE_NORMAL);
 //        }
 //    } else {
-//        page_manager_request_update(false);
+//        page_manager_request_update(EPD_UPDATE_NORMAL);
 //    }
 //}
 
@@ -89,9 +89,7 @@ void upgrade_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt) {
     epd_paint_clear(epd_paint, 0);
     if (state == INIT_LOW_BATTERY) {
         // upgrade failed icon
-        epd_paint_draw_bitmap(epd_paint, 83, 62, 32, 32,
-                              (uint8_t *) ic_close_bmp_start,
-                              ic_close_bmp_end - ic_close_bmp_start, 1);
+        epd_paint_draw_icon(epd_paint, ICON_CLOSE, 83, 62, 1);
 
         // 电量过低无法升级!
         uint16_t data[] = {0xE7B5, 0xBFC1, 0xFDB9, 0xCDB5, 0xDECE, 0xA8B7, 0xFDC9, 0xB6BC, 0x21, 0x00};
@@ -129,9 +127,7 @@ void upgrade_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt) {
                                  &Font_HZK16, 1);
     } else if (state == UPGRADING) {
         // upgrade icon
-        epd_paint_draw_bitmap(epd_paint, 75, 70, 48, 38,
-                              (uint8_t *) icon_upgrade_bmp_start,
-                              icon_upgrade_bmp_end - icon_upgrade_bmp_start, 1);
+        epd_paint_draw_icon(epd_paint, ICON_UPGRADE_LARGE, 75, 70, 1);
 
         // 固件升级中.
         uint16_t data[] = {0xCCB9, 0xFEBC, 0xFDC9, 0xB6BC, 0xD0D6, 0x2E, 0x00};
@@ -142,9 +138,7 @@ void upgrade_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt) {
         epd_paint_draw_string_at(epd_paint, 80, 134, (char *) buff, &Font16, 1);
     } else if (state == UPGRADE_FAILED) {
         // upgrade failed icon
-        epd_paint_draw_bitmap(epd_paint, 83, 62, 32, 32,
-                              (uint8_t *) ic_close_bmp_start,
-                              ic_close_bmp_end - ic_close_bmp_start, 1);
+        epd_paint_draw_icon(epd_paint, ICON_CLOSE, 83, 62, 1);
 
         // 固件升级失败.
         uint16_t data[] = {0xCCB9, 0xFEBC, 0xFDC9, 0xB6BC, 0xA7CA, 0xDCB0, 0x2E, 0x00};
@@ -156,9 +150,7 @@ void upgrade_page_draw(epd_paint_t *epd_paint, uint32_t loop_cnt) {
                                            0xFC, 0xD6, 0xD8, 0xC6, 0xF4, 0x00}, &Font_HZK16, 1);
     } else if (state == UPGRADE_SUCCESS) {
         // upgrade icon
-        epd_paint_draw_bitmap(epd_paint, 75, 70, 48, 38,
-                              (uint8_t *) icon_upgrade_bmp_start,
-                              icon_upgrade_bmp_end - icon_upgrade_bmp_start, 1);
+        epd_paint_draw_icon(epd_paint, ICON_UPGRADE_LARGE, 75, 70, 1);
 
         // 固件升级成功.
         uint16_t data[] = {0xCCB9, 0xFEBC, 0xFDC9, 0xB6BC, 0xC9B3, 0xA6B9, 0x2E, 0x00};
@@ -179,7 +171,7 @@ bool upgrade_page_key_click_handle(key_event_id_t key_event_type) {
     if (state == INIT || state == INIT_LOW_BATTERY) {
         if (key_event_type == KEY_OK_SHORT_CLICK || key_event_type == KEY_FN_SHORT_CLICK) {
             page_manager_close_page();
-            page_manager_request_update(false);
+            page_manager_request_update(EPD_UPDATE_NORMAL);
             return true;
         }
         return false;
@@ -24,15 +24,16 @@
 #include "page/tomato_clock.h"
 #include "page/alarm_clock_page.h"
 #include "page/pressure_sensor_page.h"
+#include "page/gui_trace_page.h"
 #include "battery.h"
 #include "max31328.h"
 
 #define TAG "page-manager"
 
 #if CONFIG_WIFI_ENABLED
-#define TOTAL_PAGE 14
+#define TOTAL_PAGE 15
 #else
-#define TOTAL_PAGE 13
+#define TOTAL_PAGE 14
 #endif
 
 #define TOTAL_MENU 3
@@ -158,6 +159,11 @@ static page_inst_t pages[] = {
                 .key_click_handler = pressure_sensor_page_key_click,
                 .enter_sleep_handler = pressure_sensor_page_on_enter_sleep,
                 .on_destroy_page = pressure_sensor_page_on_destroy,
+        }, {
+                .page_name = "gui-trace",
+                .on_draw_page = gui_trace_page_draw,
+                .key_click_handler = gui_trace_page_key_click,
+                .enter_sleep_handler = gui_trace_page_on_enter_sleep,
         },
 };
 
@@ -188,8 +194,6 @@ static page_inst_t menus[] = {
         }
 };
 
-bool page_manager_switch_page_by_index(int8_t dest_page_index, bool push_stack);
-
 static void key_event_handler(void *event_handler_arg, esp_event_base_t event_base, int32_t event_id,
                               void *event_data) {
     xQueueSend(event_queue, (void *) &event_id, pdMS_TO_TICKS(10));
@@ -222,6 +226,10 @@ int8_t page_manager_get_current_index() {
     return current_page_index;
 }
 
+int8_t page_manager_get_page_count() {
+    return TOTAL_PAGE;
+}
+
 bool page_manager_switch_page_by_index(int8_t dest_page_index, bool push_stack) {
     if (current_page_index == dest_page_index) {
         ESP_LOGW(TAG, "dest page is current %d", dest_page_index);
@@ -356,7 +364,7 @@ void page_manager_close_menu() {
 int page_manager_enter_sleep(uint32_t loop_cnt) {
     if (page_manager_has_menu()) {
         page_manager_close_menu();
-        page_manager_request_update(false);
+        page_manager_request_update(EPD_UPDATE_NORMAL);
         vTaskDelay(pdMS_TO_TICKS(500));
     }
 
@@ -394,8 +402,9 @@ int page_manager_enter_sleep(uint32_t loop_cnt) {
     return DEFAULT_SLEEP_TS;
 }
 
-void page_manager_request_update(uint32_t full_refresh) {
-    common_post_event_data(BIKE_REQUEST_UPDATE_DISPLAY_EVENT, 0, (void *) full_refresh, sizeof(full_refresh));
+void page_manager_request_update(epd_update_request_t request) {
+    uint32_t data = request;
+    common_post_event_data(BIKE_REQUEST_UPDATE_DISPLAY_EVENT, 0, &data, sizeof(data));
 }
 
 static void key_event_task_entry(void *arg) {
@@ -430,11 +439,11 @@ static void key_event_task_entry(void *arg) {
                 case KEY_FN_SHORT_CLICK:
                     if (page_manager_has_menu()) {
                         page_manager_close_menu();
-                        page_manager_request_update(false);
+                        page_manager_request_update(EPD_UPDATE_NORMAL);
                         continue;
                     } else {
                         if (page_manager_close_page()) {
-                            page_manager_request_update(false);
+                            page_manager_request_update(EPD_UPDATE_NORMAL);
                         }
                         continue;
                     }
@@ -443,11 +452,11 @@ static void key_event_task_entry(void *arg) {
                     if (page_manager_get_current_index() < HOME_PAGE_COUNT) {
                         if (page_manager_has_menu()) {
                             page_manager_close_menu();
-                            page_manager_request_update(false);
+                            page_manager_request_update(EPD_UPDATE_NORMAL);
                             continue;
                         } else {
                             page_manager_show_menu("menu", NULL);
-                            page_manager_request_update(false);
+                            page_manager_request_update(EPD_UPDATE_NORMAL);
                             continue;
                         }
                     }
@@ -455,11 +464,11 @@ static void key_event_task_entry(void *arg) {
                 case KEY_OK_LONG_CLICK:
                     if (page_manager_has_menu()) {
                         page_manager_close_menu();
-                        page_manager_request_update(false);
+                        page_manager_request_update(EPD_UPDATE_NORMAL);
                         continue;
                     } else {
                         page_manager_show_menu("menu", NULL);
-                        page_manager_request_update(false);
+                        page_manager_request_update(EPD_UPDATE_NORMAL);
                         continue;
                     }
                     break;
@@ -467,7 +476,7 @@ static void key_event_task_entry(void *arg) {
                     if (page_manager_get_current_index() < HOME_PAGE_COUNT) {
                         int8_t dest_index = (page_manager_get_current_index() + 1) % HOME_PAGE_COUNT;
                         if (page_manager_switch_page_by_index(dest_index, false)) {
-                            page_manager_request_update(false);
+                            page_manager_request_update(EPD_UPDATE_NORMAL);
                         }
                         continue;
                     }
@@ -5,6 +5,7 @@
 #include "stdlib.h"
 #include "lcd/epdpaint.h"
 #include "key.h"
+#include "lcd/display.h"
 
 #define TEMP_PAGE_INDEX 0
 #define IMAGE_PAGE_INDEX 1
@@ -43,6 +44,10 @@ void page_manager_init(int8_t page_index);
 
 int8_t page_manager_get_current_index();
 
+int8_t page_manager_get_page_count();
+
+bool page_manager_switch_page_by_index(int8_t dest_page_index, bool push_stack);
+
 bool page_manager_switch_page(char *page_name, bool push_stack);
 
 bool page_manager_close_page();
@@ -60,6 +65,7 @@ void page_manager_close_menu();
 // return sleep ts, -1 stop sleep, 0 never wake up by timer
 int page_manager_enter_sleep(uint32_t loop_cnt);
 
-void page_manager_request_update(uint32_t full_refresh);
+// request redraw, pages can ask for a clean (full) or no flash (partial) refresh
+void page_manager_request_update(epd_update_request_t request);
 
 #endif
\ No newline at end of file
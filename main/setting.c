@@ -12,11 +12,15 @@
 #include "setting.h"
 #include "max31328.h"
 #include "file/my_file_common.h"
+#include "file/image_index.h"
+#include "lcd/epi.h"
 
 #define TAG "BOX_SETTING"
 
 #define MAX_BMP_FILE_SIZE 8192
 #define CHECK_BMP_UPLOAD_TIMEOUT 300
+// upload task adds the file to image index: spiffs io, image header parse and a dir walk if index is missing
+#define CHECK_UPLOAD_TASK_STACK_SIZE 4096
 
 static uint8_t ping = 0;
 static SemaphoreHandle_t xSemaphore = NULL;
@@ -28,7 +32,7 @@ static uint16_t current_bmp_file_write_size = 0;
 static FILE *current_fd = NULL;
 static char bmp_filepath[ESP_VFS_PATH_MAX + CONFIG_SPIFFS_OBJ_NAME_LEN];
 
-static esp_err_t open_file(uint8_t file_id, uint16_t file_size);
+static esp_err_t open_file(uint8_t file_id, uint16_t file_size, const char *ext);
 
 static esp_err_t write_file(uint16_t offset, uint8_t *data, uint16_t data_len);
 
@@ -145,7 +149,10 @@ esp_err_t box_setting_apply(uint8_t cmd, uint8_t *data, uint16_t data_len) {
 
             // mount spiffs
             ESP_ERROR_CHECK(mount_storage(FILE_SERVER_BASE_PATH, true));
-            err = open_file(file_id, current_bmp_file_size);
+            // first packet starts with file header, epi made by tools/bmp_to_epi.py is kept as it is
+            epi_header_t epi_header;
+            bool is_epi = data_len > 3 && epi_header_read(&epi_header, data + 3, data_len - 3) == EPI_OK;
+            err = open_file(file_id, current_bmp_file_size, is_epi ? "epi" : "bmp");
             if (err != ESP_OK) {
                 return err;
             }
@@ -153,7 +160,7 @@ esp_err_t box_setting_apply(uint8_t cmd, uint8_t *data, uint16_t data_len) {
             BaseType_t creat_task_err = xTaskCreate(
                     check_upload_task_entry,
                     "check_upload_task",
-                    2048,
+                    CHECK_UPLOAD_TASK_STACK_SIZE,
                     NULL,
                     uxTaskPriorityGet(NULL),
                     &tsk_hdl);
@@ -187,7 +194,7 @@ esp_err_t box_setting_apply(uint8_t cmd, uint8_t *data, uint16_t data_len) {
     return ESP_OK;
 }
 
-static esp_err_t open_file(uint8_t file_id, uint16_t file_size) {
+static esp_err_t open_file(uint8_t file_id, uint16_t file_size, const char *ext) {
     /* File cannot be larger than a limit */
     if (file_size > MAX_BMP_FILE_SIZE) {
         ESP_LOGE(TAG, "bmp File too large : %d bytes must < %d bytes", file_size, MAX_BMP_FILE_SIZE);
@@ -201,10 +208,10 @@ static esp_err_t open_file(uint8_t file_id, uint16_t file_size) {
     struct stat file_stat;
     do {
         if (load_time_err == ESP_OK) {
-            sprintf(bmp_filepath, "%s/%02d%02d%02d%02d%02d%02d_%d.bmp", FILE_SERVER_BASE_PATH,
-                    t.year, t.month, t.day, t.hour, t.minute, t.second, rndId);
+            sprintf(bmp_filepath, "%s/%02d%02d%02d%02d%02d%02d_%d.%s", FILE_SERVER_BASE_PATH,
+                    t.year, t.month, t.day, t.hour, t.minute, t.second, rndId, ext);
         } else {
-            sprintf(bmp_filepath, "%s/b%d.bmp", FILE_SERVER_BASE_PATH, rndId);
+            sprintf(bmp_filepath, "%s/b%d.%s", FILE_SERVER_BASE_PATH, rndId, ext);
         }
         rndId += 1;
         ESP_LOGI(TAG, "bmp file path %s for file id %d", bmp_filepath, file_id);
@@ -267,6 +274,7 @@ static void check_upload_task_entry(void *arg) {
                  current_bmp_file_size, current_bmp_file_write_size);
     } else {
         ESP_LOGI(TAG, "upload bmp file success fileId:%d name:%s", current_bmp_file_id, bmp_filepath);
+        image_index_add(bmp_filepath);
     }
 
     tsk_hdl = NULL;
@@ -1,74 +1,8 @@
 #ifndef STATIC_H
 #define STATIC_H
 
-extern const uint8_t aniya_200_1_bmp_start[] asm("_binary_aniya_200_1_bmp_start");
-extern const uint8_t aniya_200_1_bmp_end[] asm("_binary_aniya_200_1_bmp_end");
-
-extern const uint8_t icon_ble_bmp_start[] asm("_binary_icon_ble_bmp_start");
-extern const uint8_t icon_ble_bmp_end[] asm("_binary_icon_ble_bmp_end");
-
-extern const uint8_t icon_sat_bmp_start[] asm("_binary_icon_sat_bmp_start");
-extern const uint8_t icon_sat_bmp_end[] asm("_binary_icon_sat_bmp_end");
-
-extern const uint8_t icon_upgrade_bmp_start[] asm("_binary_icon_upgrade_bmp_start");
-extern const uint8_t icon_upgrade_bmp_end[] asm("_binary_icon_upgrade_bmp_end");
-
-extern const uint8_t ic_home_bmp_start[] asm("_binary_ic_home_32_bmp_start");
-extern const uint8_t ic_home_bmp_end[] asm("_binary_ic_home_32_bmp_end");
-
-extern const uint8_t ic_image_bmp_start[] asm("_binary_ic_image_32_bmp_start");
-extern const uint8_t ic_image_bmp_end[] asm("_binary_ic_image_32_bmp_end");
-
-extern const uint8_t ic_manual_bmp_start[] asm("_binary_ic_manual_32_bmp_start");
-extern const uint8_t ic_manual_bmp_end[] asm("_binary_ic_manual_32_bmp_end");
-
-extern const uint8_t ic_setting_bmp_start[] asm("_binary_ic_setting_32_bmp_start");
-extern const uint8_t ic_setting_bmp_end[] asm("_binary_ic_setting_32_bmp_end");
-
-extern const uint8_t ic_info_bmp_start[] asm("_binary_ic_info_32_bmp_start");
-extern const uint8_t ic_info_bmp_end[] asm("_binary_ic_info_32_bmp_end");
-
-extern const uint8_t ic_upgrade_bmp_start[] asm("_binary_ic_upgrade_32_bmp_start");
-extern const uint8_t ic_upgrade_bmp_end[] asm("_binary_ic_upgrade_32_bmp_end");
-
-extern const uint8_t ic_close_bmp_start[] asm("_binary_ic_close_32_bmp_start");
-extern const uint8_t ic_close_bmp_end[] asm("_binary_ic_close_32_bmp_end");
-
-extern const uint8_t ic_reboot_bmp_start[] asm("_binary_ic_reboot_32_bmp_start");
-extern const uint8_t ic_reboot_bmp_end[] asm("_binary_ic_reboot_32_bmp_end");
-
-extern const uint8_t ic_back_bmp_start[] asm("_binary_ic_back_32_bmp_start");
-extern const uint8_t ic_back_bmp_end[] asm("_binary_ic_back_32_bmp_end");
-
-extern const uint8_t ic_ble_bmp_start[] asm("_binary_ic_ble_32_bmp_start");
-extern const uint8_t ic_ble_bmp_end[] asm("_binary_ic_ble_32_bmp_end");
-
-extern const uint8_t ic_music_bmp_start[] asm("_binary_ic_music_32_bmp_start");
-extern const uint8_t ic_music_bmp_end[] asm("_binary_ic_music_32_bmp_end");
-
-extern const uint8_t ic_battery_bmp_start[] asm("_binary_ic_battery_32_bmp_start");
-extern const uint8_t ic_battery_bmp_end[] asm("_binary_ic_battery_32_bmp_end");
-
-extern const uint8_t ic_tomato_bmp_start[] asm("_binary_ic_tomato_32_bmp_start");
-extern const uint8_t ic_tomato_bmp_end[] asm("_binary_ic_tomato_32_bmp_end");
-
-extern const uint8_t ic_studying_bmp_start[] asm("_binary_ic_studying_32_bmp_start");
-extern const uint8_t ic_studying_bmp_end[] asm("_binary_ic_studying_32_bmp_end");
-
-extern const uint8_t ic_playing_bmp_start[] asm("_binary_ic_playing_32_bmp_start");
-extern const uint8_t ic_playing_bmp_end[] asm("_binary_ic_playing_32_bmp_end");
-
-extern const uint8_t ic_summary_bmp_start[] asm("_binary_ic_summary_32_bmp_start");
-extern const uint8_t ic_summary_bmp_end[] asm("_binary_ic_summary_32_bmp_end");
-
-extern const uint8_t ic_alarm_bmp_start[] asm("_binary_ic_alarm_32_bmp_start");
-extern const uint8_t ic_alarm_bmp_end[] asm("_binary_ic_alarm_32_bmp_end");
-
-extern const uint8_t ic_time_bmp_start[] asm("_binary_ic_time_32_bmp_start");
-extern const uint8_t ic_time_bmp_end[] asm("_binary_ic_time_32_bmp_end");
-
-extern const uint8_t ic_pressure_bmp_start[] asm("_binary_ic_pressure_32_bmp_start");
-extern const uint8_t ic_pressure_bmp_end[] asm("_binary_ic_pressure_32_bmp_end");
+extern const uint8_t aniya_200_1_epi_start[] asm("_binary_aniya_200_1_epi_start");
+extern const uint8_t aniya_200_1_epi_end[] asm("_binary_aniya_200_1_epi_end");
 
 // https://www.qqxiuzi.cn/bianma/zifuji.php
 
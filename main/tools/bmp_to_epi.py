@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+"""
+convert bmp to epi, the native 1 bit image of lcd/epi.h.
+run by the build over main/static, and on pc for images uploaded by ble:
+
+    python3 bmp_to_epi.py in.bmp out.epi [--raw]
+
+1 4 8 24 32 bit bmp, pixel is white when gray >= 128. rows are packbits when it is smaller, unless --raw.
+"""
+import argparse
+import os
+import struct
+import sys
+
+EPI_MAGIC = 0x31495045  # "EPI1"
+EPI_FLAG_PACKBITS = 1 << 0
+EPI_MAX_ROW_BYTES = 64
+
+BI_RGB = 0
+
+
+def gray(r, g, b):
+    # same as rgb_to_gray of lcd/bmp.c
+    return (r * 77 + g * 151 + b * 28) >> 8
+
+
+def read_bmp(data):
+    """returns width, height, rows top down of white flags"""
+    if data[:2] != b'BM':
+        raise ValueError('not a bmp file')
+    off_bits, = struct.unpack_from('<I', data, 10)
+    bi_size, width, height, _, bit_count, compression = struct.unpack_from('<IiiHHI', data, 14)
+    clr_used, = struct.unpack_from('<I', data, 46)
+    if bit_count not in (1, 4, 8, 24, 32) or compression != BI_RGB:
+        raise ValueError('bmp of %d bit compression %d not supported' % (bit_count, compression))
+
+    palette = []
+    if bit_count <= 8:
+        count = clr_used or (1 << bit_count)
+        for i in range(count):
+            b, g, r, _ = struct.unpack_from('<BBBB', data, 14 + bi_size + i * 4)
+            palette.append(gray(r, g, b) >= 128)
+
+    stride = ((width * bit_count + 31) & ~31) >> 3
+    rows = []
+    for y in range(abs(height)):
+        src_y = y if height < 0 else height - 1 - y
+        line = data[off_bits + src_y * stride:off_bits + (src_y + 1) * stride]
+        if len(line) < stride:
+            raise ValueError('bmp data short')
+        row = []
+        for x in range(width):
+            if bit_count <= 8:
+                bit = x * bit_count
+                index = (line[bit >> 3] >> (8 - bit_count - (bit & 7))) & ((1 << bit_count) - 1)
+                row.append(palette[index])
+            else:
+                p = x * (bit_count >> 3)
+                row.append(gray(line[p + 2], line[p + 1], line[p]) >= 128)
+        rows.append(row)
+    return width, abs(height), rows
+
+
+def pack_row_bits(row):
+    out = bytearray((len(row) + 7) >> 3)
+    for x, white in enumerate(row):
+        if white:
+            out[x >> 3] |= 0x80 >> (x & 7)
+    return bytes(out)
+
+
+def packbits(row):
+    out = bytearray()
+    i = 0
+    n = len(row)
+    while i < n:
+        j = i + 1
+        while j < n and row[j] == row[i] and j - i < 128:
+            j += 1
+        if j - i >= 2:
+            out += bytes([(257 - (j - i)) & 0xff, row[i]])
+            i = j
+            continue
+        # literal till a run of 3 starts
+        j = i
+        while j < n and j - i < 128:
+            if j + 2 < n and row[j] == row[j + 1] == row[j + 2]:
+                break
+            j += 1
+        out.append(j - i - 1)
+        out += row[i:j]
+        i = j
+    return bytes(out)
+
+
+def bmp_to_epi(data, raw=False):
+    width, height, rows = read_bmp(data)
+    if (width + 7) >> 3 > EPI_MAX_ROW_BYTES:
+        raise ValueError('width %d over %d' % (width, EPI_MAX_ROW_BYTES * 8))
+    plain = [pack_row_bits(row) for row in rows]
+    packed = [packbits(row) for row in plain]
+    use_packbits = not raw and sum(map(len, packed)) < sum(map(len, plain))
+    header = struct.pack('<IHHB3x', EPI_MAGIC, width, height, EPI_FLAG_PACKBITS if use_packbits else 0)
+    return header + b''.join(packed if use_packbits else plain)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='convert bmp to epi 1 bit image')
+    parser.add_argument('input')
+    parser.add_argument('output')
+    parser.add_argument('--raw', action='store_true', help='no packbits, rows can be drawn from flash directly')
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as f:
+        data = f.read()
+    try:
+        epi = bmp_to_epi(data, args.raw)
+    except ValueError as e:
+        sys.exit('%s: %s' % (args.input, e))
+    out_dir = os.path.dirname(args.output)
+    if out_dir:
+        os.makedirs(out_dir, exist_ok=True)
+    with open(args.output, 'wb') as f:
+        f.write(epi)
+
+
+if __name__ == '__main__':
+    main()
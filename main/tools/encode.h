@@ -1,6 +1,8 @@
 #ifndef ENCODE_H
 #define ENCODE_H
 
+#include <stdint.h>
+
 void
 utf8_to_utf16(unsigned char *utf8_str, int utf8_str_size, uint16_t *utf16_str_output, int utf16_str_output_size);
 
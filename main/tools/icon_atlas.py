@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+"""
+make icon atlas of lcd/icon.h from the list in static/icons.txt, run by the build:
+
+    python3 icon_atlas.py icons.txt out_dir
+
+writes out_dir/icon_id.h and out_dir/icon_atlas.c. every icon is stored 4 times,
+turned to the frame buffer layout of ROTATE_0 / 90 / 180 / 270 of lcd/epdpaint.c,
+so any rotation is drawn by byte rows. rows are msb first, bit 1 is white.
+"""
+import argparse
+import os
+import sys
+
+from bmp_to_epi import read_bmp, pack_row_bits
+
+ROTATIONS = ('ROTATE_0', 'ROTATE_90', 'ROTATE_180', 'ROTATE_270')
+
+
+def read_list(list_path):
+    icons = []
+    with open(list_path) as f:
+        for n, line in enumerate(f, 1):
+            line = line.split('#', 1)[0].strip()
+            if not line:
+                continue
+            parts = line.split()
+            if len(parts) != 2:
+                raise ValueError('%s:%d: want "id bmp"' % (list_path, n))
+            icons.append((parts[0], os.path.join(os.path.dirname(list_path), parts[1])))
+    return icons
+
+
+def rotate(rows, rotation):
+    """
+    rows of frame buffer for icon drawn at rotation, pixel (i, j) of icon goes to
+    90: (width - y - j, x + i), 180: (width - x - i, height - y - j), 270: (y + j, height - x - i)
+    """
+    h = len(rows)
+    w = len(rows[0])
+    if rotation == 0:
+        return rows
+    if rotation == 1:
+        return [[rows[h - 1 - c][r] for c in range(h)] for r in range(w)]
+    if rotation == 2:
+        return [[rows[h - 1 - r][w - 1 - c] for c in range(w)] for r in range(h)]
+    return [[rows[c][w - 1 - r] for c in range(h)] for r in range(w)]
+
+
+def c_bytes(data, indent):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append(indent + ', '.join('0x%02x' % b for b in data[i:i + 16]) + ',')
+    return '\n'.join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='make pre-rotated 1 bit icon atlas')
+    parser.add_argument('list')
+    parser.add_argument('out_dir')
+    args = parser.parse_args()
+
+    try:
+        icons = read_list(args.list)
+        data = bytearray()
+        entries = []
+        for name, path in icons:
+            with open(path, 'rb') as f:
+                width, height, rows = read_bmp(f.read())
+            variants = []
+            for rotation in range(len(ROTATIONS)):
+                turned = rotate(rows, rotation)
+                variants.append((len(turned[0]), len(turned), len(data)))
+                for row in turned:
+                    data += pack_row_bits(row)
+            entries.append((name, width, height, variants))
+    except (OSError, ValueError) as e:
+        sys.exit('%s: %s' % (args.list, e))
+
+    os.makedirs(args.out_dir, exist_ok=True)
+    with open(os.path.join(args.out_dir, 'icon_id.h'), 'w') as f:
+        f.write('// made by tools/icon_atlas.py from static/icons.txt, do not edit\n')
+        f.write('#ifndef ICON_ID_H\n#define ICON_ID_H\n\n')
+        f.write('enum icon_id {\n')
+        for name, width, height, _ in entries:
+            f.write('    ICON_%s, // %dx%d\n' % (name.upper(), width, height))
+        f.write('    ICON_COUNT\n};\n\n#endif\n')
+
+    with open(os.path.join(args.out_dir, 'icon_atlas.c'), 'w') as f:
+        f.write('// made by tools/icon_atlas.py from static/icons.txt, do not edit\n')
+        f.write('#include "lcd/icon.h"\n\n')
+        f.write('const uint8_t icon_atlas_data[] = {\n%s\n};\n\n' % c_bytes(data, '        '))
+        f.write('const icon_t icon_atlas[ICON_COUNT][4] = {\n')
+        for name, _, _, variants in entries:
+            f.write('        [ICON_%s] = {%s},\n' % (
+                name.upper(), ', '.join('{%d, %d, %d}' % v for v in variants)))
+        f.write('};\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -52,7 +52,7 @@ void list_view_add_element(list_view_t *list_view, char *text) {
         ESP_LOGE(TAG, "no memory for new list_view element");
     }
 
-    ele->text = calloc(strlen(text), sizeof(char));
+    ele->text = calloc(strlen(text) + 1, sizeof(char));
     strcpy(ele->text, text);
 
     //ele->text = text;
@@ -229,7 +229,7 @@ bool view_group_handle_key_event(view_group_view_t *group, key_event_id_t event)
                         curr_focus->v->key_event(curr_focus->v, event);
                     }
 
-                    page_manager_request_update(false);
+                    page_manager_request_update(EPD_UPDATE_NORMAL);
                     return true;
                 }
             }
@@ -239,14 +239,14 @@ bool view_group_handle_key_event(view_group_view_t *group, key_event_id_t event)
                 if (curr_focus->v->state == VIEW_STATE_SELECTED) {
                     // unselect view
                     curr_focus->v->state = VIEW_STATE_FOCUS;
-                    page_manager_request_update(false);
+                    page_manager_request_update(EPD_UPDATE_NORMAL);
                     return true;
                 }
             }
             break;
         case KEY_UP_SHORT_CLICK:
             if (view_group_focus_pre(group)) {
-                page_manager_request_update(false);
+                page_manager_request_update(EPD_UPDATE_NORMAL);
                 return true;
             }
 
@@ -254,7 +254,7 @@ bool view_group_handle_key_event(view_group_view_t *group, key_event_id_t event)
                 if (curr_focus->v->key_event != NULL) {
                     bool handle = curr_focus->v->key_event(curr_focus->v, event);
                     if (handle) {
-                        page_manager_request_update(false);
+                        page_manager_request_update(EPD_UPDATE_NORMAL);
                     }
                     return handle;
                 }
@@ -262,7 +262,7 @@ bool view_group_handle_key_event(view_group_view_t *group, key_event_id_t event)
             break;
         case KEY_DOWN_SHORT_CLICK:
             if (view_group_focus_next(group)) {
-                page_manager_request_update(false);
+                page_manager_request_update(EPD_UPDATE_NORMAL);
                 return true;
             }
 
@@ -270,7 +270,7 @@ bool view_group_handle_key_event(view_group_view_t *group, key_event_id_t event)
                 if (curr_focus->v->key_event != NULL) {
                     bool handle = curr_focus->v->key_event(curr_focus->v, event);
                     if (handle) {
-                        page_manager_request_update(false);
+                        page_manager_request_update(EPD_UPDATE_NORMAL);
                     }
                     return handle;
                 }